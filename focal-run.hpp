@@ -0,0 +1,7626 @@
+// Focal-RUN as a library: include this header and drive FocalRun in-process.
+//
+//   FocalRun focal({"--path=src", "--debug"});
+//   focal.onEvent([](const BuildEvent& event) { ... });
+//   const auto& index = focal.discover();   // scanned once, reused
+//   BuildPlan plan = focal.plan({"app"});
+//   for (const auto& proj : focal.build({"app"})) { ... proj.success ... }
+//
+// Errors are thrown as FocalRunError. focal-run.cpp is the command-line wrapper
+#ifndef FOCAL_RUN_HPP
+#define FOCAL_RUN_HPP
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <filesystem>
+#include <cstdlib>
+#include <map>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <future>
+#include <functional>
+#include <deque>
+#include <unordered_map>
+#include <unordered_set>
+#include <memory>
+#include <set>
+#include <tuple>
+#include <cctype>
+#include <iomanip>
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include <atomic>
+#include <condition_variable>
+#include <array>
+
+namespace fs = std::filesystem;
+
+// Platform-specific definitions
+#ifdef _WIN32
+    #include <windows.h>
+    #define QUIET_REDIRECT " >nul 2>&1"
+    #define QUIET_STDERR " 2>nul"
+    #define PATH_SEPARATOR "\\"
+#else
+    #include <cerrno>
+    #include <fcntl.h>
+    #include <netdb.h>
+    #include <poll.h>
+    #include <sys/file.h>
+    #include <sys/ioctl.h>
+    #include <sys/resource.h>
+    #include <sys/socket.h>
+    #include <sys/wait.h>
+    #include <unistd.h>
+    #define QUIET_REDIRECT " >/dev/null 2>&1"
+    #define QUIET_STDERR " 2>/dev/null"
+    #define PATH_SEPARATOR "/"
+#endif
+
+#ifdef __linux__
+    #include <sched.h>
+    #include <sys/syscall.h>
+    #include <linux/fs.h>
+#endif
+
+// ANSI Color codes
+namespace Color {
+    const std::string RESET = "\033[0m";
+    const std::string RED = "\033[31m";
+    const std::string GREEN = "\033[32m";
+    const std::string YELLOW = "\033[33m";
+    const std::string BLUE = "\033[34m";
+    const std::string MAGENTA = "\033[35m";
+    const std::string CYAN = "\033[36m";
+    const std::string BOLD = "\033[1m";
+}
+
+enum class BuildSystem {
+    CMake,
+    Make,
+    Ninja,
+    MinGW,
+    GCC,
+    Rust,
+    Auto
+};
+
+struct ResourceUsage {
+    long cpuUserMs = 0;
+    long cpuSysMs = 0;
+    long peakRssKb = 0;     // Peak memory of the whole process tree, see runCommand
+    long blockIn = 0;
+    long blockOut = 0;
+    long ctxVoluntary = 0;
+    long ctxInvoluntary = 0;
+
+    // Totals over successive build steps; peak RSS is the largest single step
+    void add(const ResourceUsage& other) {
+        cpuUserMs += other.cpuUserMs;
+        cpuSysMs += other.cpuSysMs;
+        peakRssKb = std::max(peakRssKb, other.peakRssKb);
+        blockIn += other.blockIn;
+        blockOut += other.blockOut;
+        ctxVoluntary += other.ctxVoluntary;
+        ctxInvoluntary += other.ctxInvoluntary;
+    }
+};
+
+struct BuildStats {
+    std::chrono::milliseconds configTime{0};
+    std::chrono::milliseconds buildTime{0};
+    std::chrono::milliseconds totalTime{0};
+    ResourceUsage usage;
+    size_t testsPassed = 0;
+    size_t testsCached = 0;
+    size_t testsFailed = 0;
+};
+
+// What one build slot is doing, published by its worker thread with atomics
+// and read by the dashboard renderer without taking the output lock
+struct SlotStatus {
+    std::atomic<int> project{-1};
+    std::atomic<int> phase{0};
+    std::atomic<long long> startedMs{0};
+    std::atomic<long> estimateMs{0};
+    std::atomic<unsigned> lineVersion{0};   // seqlock: odd while the line is written
+    std::array<std::atomic<char>, 160> line{};
+};
+
+// Wraps stdout/stderr while the dashboard is shown: the first write after a
+// redraw erases the dashboard, so regular output scrolls above it
+class DashboardBuf : public std::streambuf {
+public:
+    DashboardBuf(std::streambuf* target, std::atomic<int>& lines) : target(target), lines(lines) {}
+
+    // Erase the dashboard drawn below the cursor, if any
+    void erase() {
+        int drawn = lines.exchange(0);
+        if (drawn > 0) {
+            std::string clear = "\033[" + std::to_string(drawn) + "A\033[J";
+            target->sputn(clear.data(), clear.size());
+        }
+    }
+
+    std::streambuf* target;
+
+protected:
+    int overflow(int c) override {
+        erase();
+        return c == EOF ? 0 : target->sputc(static_cast<char>(c));
+    }
+
+    std::streamsize xsputn(const char* text, std::streamsize count) override {
+        erase();
+        return target->sputn(text, count);
+    }
+
+    int sync() override { return target->pubsync(); }
+
+private:
+    std::atomic<int>& lines;
+};
+
+// Connection to a `focal-run --worker` process
+struct RemoteWorker {
+    std::string address;
+    std::string host;
+    int fd = -1;
+    size_t slots = 1;
+    size_t busy = 0;
+    bool alive = true;
+    std::mutex sendMutex;
+    std::thread reader;
+    std::unordered_map<std::string, size_t> inflight;
+};
+
+struct SystemLoad {
+    long memTotalKb = 0;
+    long memAvailableKb = 0;
+    double memPressure = 0.0;
+    double loadAverage = 0.0;
+};
+
+struct BenchTarget {
+    std::string project;
+    std::string name;
+    std::string command;
+};
+
+struct BenchResult {
+    BenchTarget target;
+    std::vector<double> samples;
+    std::vector<double> baseline;
+    bool success = false;
+    double pValue = 1.0;
+    bool regression = false;
+    bool improvement = false;
+};
+
+struct ArtifactStats {
+    std::string project;
+    std::string name;
+    std::string path;
+    uintmax_t size = 0;
+    uintmax_t text = 0;
+    uintmax_t rodata = 0;
+    uintmax_t data = 0;
+    uintmax_t bss = 0;
+    int needed = -1;        // DT_NEEDED entries; -1 when the file is not ELF
+    bool timed = false;     // Opted in with a Focal-Startup marker
+    std::vector<std::string> startupArgs;
+    double coldMs = -1.0;   // -1 when not run or timed out
+    double warmMs = -1.0;
+    std::vector<std::string> baseline;
+    std::vector<std::string> regressions;
+};
+
+// Advisory lock on a file, shared with other focal-run processes on the host
+// (flock, dropped when the descriptor closes). Where a lock file cannot be
+// opened, or on Windows, acquire succeeds and the run is uncoordinated
+struct FileLock {
+    int fd = -1;
+
+    FileLock() = default;
+    FileLock(const FileLock&) = delete;
+    FileLock& operator=(const FileLock&) = delete;
+    ~FileLock() { release(); }
+
+    bool acquire(const std::string& path, bool wait) {
+#ifdef _WIN32
+        (void)path;
+        (void)wait;
+        return true;
+#else
+        release();
+        fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd < 0) return true;
+        while (flock(fd, LOCK_EX | (wait ? 0 : LOCK_NB)) != 0) {
+            if (errno == EINTR) continue;
+            release();
+            return false;
+        }
+        return true;
+#endif
+    }
+
+    // Contents of the held lock file: the holder's pid, or the result it left behind
+    std::string read() const {
+        std::string text;
+#ifndef _WIN32
+        char buffer[4096];
+        ssize_t n = fd < 0 ? -1 : pread(fd, buffer, sizeof(buffer), 0);
+        if (n > 0) text.assign(buffer, n);
+#endif
+        return text;
+    }
+
+    void write(const std::string& text) {
+#ifdef _WIN32
+        (void)text;
+#else
+        if (fd < 0 || ftruncate(fd, 0) != 0) return;
+        if (pwrite(fd, text.data(), text.size(), 0) < 0) return;
+#endif
+    }
+
+    void release() {
+#ifndef _WIN32
+        if (fd >= 0) close(fd);
+#endif
+        fd = -1;
+    }
+};
+
+// One test binary (cargo) or CTest test, run as its own job in the test stage
+struct TestUnit {
+    size_t project = 0;
+    std::string name;
+    std::string command;
+    std::string key;                // test binary hash plus its inputs
+    long expectedMs = 0;
+    bool success = false;
+    bool cached = false;
+    std::chrono::milliseconds duration{0};
+    std::deque<std::string> tail;   // last output lines, shown when it fails
+};
+
+// Parsed JSON value (see FocalRun::parseJson)
+struct JsonValue {
+    enum class Type { Null, Bool, Number, String, Array, Object };
+    Type type = Type::Null;
+    std::string text;
+    double number = 0.0;
+    std::vector<JsonValue> items;
+    std::vector<std::pair<std::string, JsonValue>> members;
+
+    const JsonValue* find(const std::string& key) const {
+        for (const auto& member : members) {
+            if (member.first == key) return &member.second;
+        }
+        return nullptr;
+    }
+
+    // String member, or "" when missing or not a string
+    std::string str(const std::string& key) const {
+        const JsonValue* value = find(key);
+        return value && value->type == Type::String ? value->text : "";
+    }
+};
+
+// Accumulated compile time of one header, translation unit, template or phase
+struct TimeTotal {
+    double ms = 0.0;
+    size_t count = 0;
+};
+
+struct ProjectInfo {
+    std::string name;
+    std::string path;
+    bool success = false;
+    std::string buildType = "Release";
+    std::string config = "";  // Set on each per-configuration copy with --configs
+    std::string buildDir = "";  // Replaces the CMake build tree, for --tune's scratch trees
+    BuildSystem buildSystem = BuildSystem::Auto;
+    std::string detectedGenerator = "";
+    bool isMakefileProject = false;
+    BuildStats stats;
+    std::string packageName = "";
+    std::string workspaceRoot = "";
+    std::vector<std::string> workspaceMembers;
+    std::string cargoTargetDir = "";
+    std::string artifactKey = "";
+    fs::file_time_type artifactSince;  // Build start; Makefile outputs older than it are not stored
+    bool restoredFromCache = false;
+    std::string inputSig = "";
+    bool hasDependents = false;   // Output hash needed for early cutoff of the jobs above it
+    std::string outputHash = "";
+    bool upToDate = false;        // Skipped: own inputs and dependency outputs unchanged
+    bool reusedBuild = false;     // Built meanwhile by another focal-run process
+};
+
+// Invalid options or inputs. Nothing in FocalRun calls exit(); the CLI prints
+// the message and exits with exitCode
+class FocalRunError : public std::runtime_error {
+public:
+    explicit FocalRunError(const std::string& message, int exitCode = 1)
+        : std::runtime_error(message), exitCode(exitCode) {}
+
+    int exitCode;
+};
+
+// Progress of FocalRun::build(), passed to the onEvent handler
+struct BuildEvent {
+    enum class Type {
+        Started,    // First stage of a project began; text is the phase
+        Output,     // Latest output or status line of a running project
+        Finished    // Result is final: success, stats, upToDate, reusedBuild
+    };
+    Type type = Type::Started;
+    const ProjectInfo* project = nullptr;  // Valid during the call only
+    std::string text;
+};
+
+// One job of FocalRun::plan(); workspace members share their root's entry
+struct PlanEntry {
+    std::string project;
+    std::string path;               // Relative to --path
+    bool rebuild = false;
+    std::string reason;             // "sources changed", "depends on x", ...
+    long estimateMs = 0;
+    bool estimated = false;         // No recorded time, the median is used
+    std::vector<std::string> dependsOn;
+};
+
+struct BuildPlan {
+    std::vector<PlanEntry> entries;
+    size_t rebuilds = 0;
+    long workMs = 0;
+    std::vector<std::string> criticalPath;
+    long criticalMs = 0;
+    std::vector<std::string> cycle;  // First dependency cycle found, e.g. a -> b -> a
+    size_t jobs = 0;                // Slots the makespan is simulated with
+    long makespanMs = 0;
+    std::vector<std::pair<size_t, long>> scaling;  // Slots -> makespan, until the critical path bounds it
+};
+
+class FocalRun {
+private:
+    std::vector<ProjectInfo> projects;
+    std::string buildType = "Release";
+    bool rebuildMode = false;
+    bool cleanMode = false;
+    bool allMode = false;
+    bool verboseMode = false;
+    bool buildMode = false;
+    bool checkMode = false;
+    bool colorOutput = true;
+    bool showProgress = true;
+    std::unique_ptr<SlotStatus[]> slots;
+    size_t slotCount = 0;
+    static inline thread_local int currentSlot = -1;
+    std::atomic<int> dashboardLines{0};
+    std::atomic<size_t> dashboardDone{0};
+    std::atomic<size_t> dashboardTotal{0};
+    bool dashboardActive = false;
+    std::string targetProject = "";
+    std::string singleFile = "";
+    std::string customPath = ".";
+    std::vector<std::string> cleanedBuildDirs;
+    std::mutex outputMutex;
+    std::unordered_map<std::string, std::string> configCache;
+    std::unordered_map<std::string, std::string> loadedCache;  // As read from disk, to merge on save
+    std::string cacheFilePath = ".focal-run-cache";
+    std::unordered_map<std::string, std::unordered_set<std::string>> dependencyGraph;
+    std::string changedSince = "";
+    std::vector<std::string> changedFiles;
+    bool changedMode = false;
+    size_t shardIndex = 0;
+    size_t shardCount = 0;
+    std::string shardTimingsFile = "";
+    std::string reportFile = "";
+    std::vector<std::string> mergeReports;
+    bool artifactCacheMode = false;
+    std::string artifactCacheDir = "";
+    unsigned long long artifactCacheLimit = 10ULL << 30;
+    std::mutex toolchainMutex;
+    std::unordered_map<std::string, std::string> toolchainSignatures;
+    bool workerMode = false;
+    std::string workerPort = "7420";
+    std::string workerBind = "127.0.0.1";
+    std::string workerToken = "";
+    size_t workerSlots = 0;
+    std::mutex workerSlotMutex;
+    std::condition_variable workerSlotCv;
+    size_t workerActive = 0;                      // Child builds running, across all coordinators
+    size_t workerQueued = 0;                      // Accepted, waiting for a slot
+    bool singleProjectMode = false;
+    std::vector<std::string> workerAddresses;
+    std::vector<std::pair<std::string, std::string>> pathMappings;
+    std::string selfExecutable = "focal-run";
+    bool rustMode = false;
+    std::string cargoCommand = "build";
+    bool testMode = false;
+    bool testCacheMode = true;
+    size_t maxConcurrentBuilds = 8;
+    size_t requestedJobs = 0;
+    size_t globalJobs = 0;
+    bool planMode = false;
+    bool tuneMode = false;
+    unsigned long long gcBudget = 0;
+    size_t adaptiveCeiling = 8;
+    size_t configureJobs = 0;
+    bool jobsExplicit = false;
+    bool adaptiveMode = true;
+    std::atomic<size_t> activeSlots{8};
+    bool pinSlotsMode = false;
+    bool numaMode = false;
+    std::vector<std::vector<int>> slotCpus;
+    std::vector<int> laneUsers;   // Threads pinned to each slotCpus set
+    std::mutex laneMutex;
+    std::string priorityLane = "";
+    bool benchMode = false;
+    int benchRepetitions = 5;
+    int benchCpu = -1;
+    double benchThreshold = 5.0;
+    std::string benchPattern = "*bench*";
+    std::string benchLabel = "bench";
+    std::string benchTag = "";
+    std::string benchBaseline = "";
+    std::string benchHistoryFile = ".focal-run-bench-history";
+    bool artifactStatsMode = false;
+    int artifactRuns = 5;
+    double artifactThreshold = 5.0;
+    std::string artifactHistoryFile = ".focal-run-artifact-history";
+    bool benchRegressed = false;
+    std::string historyRun = "";
+    bool helpMode = false;
+    bool scanMode = false;
+    bool nothingToBuild = false;                  // A selection option left nothing to do
+    std::vector<ProjectInfo> projectIndex;        // discover() result, reused across queries
+    bool indexed = false;
+    std::function<void(const BuildEvent&)> eventHandler;
+    std::mutex eventMutex;
+    bool selfBenchMode = false;
+    bool sharedTargetMode = false;
+    bool sccacheMode = false;
+    std::string sharedTargetRoot = "";
+    std::map<std::string, std::mutex> targetDirLocks;
+    bool ninjaGraphMode = false;
+    std::string ninjaGraphRoot = "";
+    std::unordered_map<std::string, std::string> ninjaGraphPrefixes;
+    std::vector<std::string> buildConfigs;
+    bool multiConfigGenerator = false;
+    std::map<std::string, std::mutex> buildDirLocks;
+    std::unordered_set<std::string> configuredBuildDirs;
+    std::string buildRoot = "";
+    unsigned long long buildRootQuota = 0;
+    std::unordered_map<std::string, std::string> buildRootDirs;
+    bool timeReportMode = false;
+    std::map<std::string, bool> clangCompilers;
+    std::map<std::string, TimeTotal> timeReportUnits;
+    std::map<std::string, TimeTotal> timeReportHeaders;
+    std::map<std::string, TimeTotal> timeReportTemplates;
+    std::map<std::string, TimeTotal> timeReportPhases;
+    size_t selfBenchDirs = 3000;
+    size_t selfBenchProjects = 300;
+
+    // Enable color output on Windows
+    void enableColorOutput() {
+#ifdef _WIN32
+        HANDLE hOut = GetStdHandle(STD_OUTPUT_HANDLE);
+        DWORD dwMode = 0;
+        if (GetConsoleMode(hOut, &dwMode)) {
+            SetConsoleMode(hOut, dwMode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+        }
+#endif
+    }
+
+    // Colorize output if enabled
+    std::string colorize(const std::string& text, const std::string& color) {
+        if (!colorOutput) return text;
+        return color + text + Color::RESET;
+    }
+
+    // Escape shell arguments to prevent injection
+    std::string escapeShellArg(const std::string& arg) {
+        std::string result = arg;
+#ifdef _WIN32
+        // Windows: escape quotes
+        size_t pos = 0;
+        while ((pos = result.find('"', pos)) != std::string::npos) {
+            result.insert(pos, "\\");
+            pos += 2;
+        }
+#else
+        // Unix: escape dangerous characters
+        const std::string dangerous = "`$\\\"!";
+        for (char c : dangerous) {
+            size_t pos = 0;
+            while ((pos = result.find(c, pos)) != std::string::npos) {
+                result.insert(pos, "\\");
+                pos += 2;
+            }
+        }
+#endif
+        return result;
+    }
+
+    // Check if command is available
+    bool isCommandAvailable(const std::string& cmd) {
+#ifdef _WIN32
+        std::string checkCmd = "where " + cmd + QUIET_REDIRECT;
+#else
+        std::string checkCmd = "which " + cmd + QUIET_REDIRECT;
+#endif
+        return system(checkCmd.c_str()) == 0;
+    }
+
+    // Run command and capture its standard output
+    std::string captureCommand(const std::string& cmd) {
+#ifdef _WIN32
+        FILE* pipe = _popen(cmd.c_str(), "r");
+#else
+        FILE* pipe = popen(cmd.c_str(), "r");
+#endif
+        if (!pipe) return "";
+
+        std::string output;
+        char buffer[4096];
+        size_t n;
+        while ((n = fread(buffer, 1, sizeof(buffer), pipe)) > 0) {
+            output.append(buffer, n);
+        }
+#ifdef _WIN32
+        _pclose(pipe);
+#else
+        pclose(pipe);
+#endif
+        return output;
+    }
+
+    // Summed RSS of a process and all its live descendants, from /proc
+    static long treeRssKb(pid_t root) {
+        long total = 0;
+#ifdef __linux__
+        std::unordered_map<long, std::vector<long>> children;
+        std::unordered_map<long, long> rssPages;
+        std::error_code ec;
+        for (const auto& entry : fs::directory_iterator("/proc", ec)) {
+            std::string name = entry.path().filename().string();
+            if (name.empty() || !std::isdigit((unsigned char)name[0])) continue;
+            std::ifstream statFile(entry.path() / "stat");
+            std::string stat;
+            std::getline(statFile, stat);
+            size_t close = stat.rfind(')');
+            if (close == std::string::npos) continue;
+            // After "pid (comm)": state ppid ... with rss the 22nd field
+            std::istringstream fields(stat.substr(close + 2));
+            std::string field;
+            long pid = std::atol(name.c_str()), ppid = 0, rss = 0;
+            for (int i = 0; fields >> field && i < 22; ++i) {
+                if (i == 1) ppid = std::atol(field.c_str());
+                if (i == 21) rss = std::atol(field.c_str());
+            }
+            children[ppid].push_back(pid);
+            rssPages[pid] = rss;
+        }
+
+        long pageKb = sysconf(_SC_PAGESIZE) / 1024;
+        std::vector<long> pending = {(long)root};
+        while (!pending.empty()) {
+            long pid = pending.back();
+            pending.pop_back();
+            total += rssPages[pid] * pageKb;
+            auto found = children.find(pid);
+            if (found != children.end()) pending.insert(pending.end(), found->second.begin(), found->second.end());
+        }
+#else
+        (void)root;
+#endif
+        return total;
+    }
+
+#ifndef _WIN32
+    // A pipe whose ends close on exec: builds forked by other threads meanwhile
+    // must not inherit the write end and keep it open past this child's exit
+    static bool openPipe(int fds[2]) {
+#ifdef __linux__
+        return pipe2(fds, O_CLOEXEC) == 0;
+#else
+        if (pipe(fds) != 0) return false;
+        fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+        fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+        return true;
+#endif
+    }
+#endif
+
+    // Run a shell command like system(), reporting the resource usage of its process tree
+    // With onLine, stdout and stderr are captured and handed over line by line. Peak
+    // memory is the largest summed RSS of the shell and its descendants, sampled
+    // every 100ms on Linux; ru_maxrss, the largest single process reaped, is the
+    // floor for steps shorter than that and the only figure elsewhere
+    int runCommand(const std::string& cmd, ResourceUsage* usage = nullptr,
+                   const std::function<void(const std::string&)>& onLine = nullptr) {
+#ifdef _WIN32
+        (void)usage;
+        (void)onLine;
+        return system(cmd.c_str());
+#else
+        int output[2] = {-1, -1};
+        if (onLine && !openPipe(output)) return -1;
+
+        pid_t pid = fork();
+        if (pid < 0) {
+            if (onLine) {
+                close(output[0]);
+                close(output[1]);
+            }
+            return -1;
+        }
+        if (pid == 0) {
+            if (onLine) {
+                dup2(output[1], STDOUT_FILENO);
+                dup2(output[1], STDERR_FILENO);
+                close(output[0]);
+                close(output[1]);
+            }
+            execl("/bin/sh", "sh", "-c", cmd.c_str(), (char*)nullptr);
+            _exit(127);
+        }
+
+        // wait4 folds in every descendant the shell reaped (make, compilers, linkers)
+        int status = 0;
+        struct rusage ru {};
+        bool reaped = false;
+        long sampledRssKb = 0;
+        auto lastSample = std::chrono::steady_clock::now();
+        auto sample = [&]() {
+            if (!usage || std::chrono::steady_clock::now() - lastSample < std::chrono::milliseconds(100)) return;
+            sampledRssKb = std::max(sampledRssKb, treeRssKb(pid));
+            lastSample = std::chrono::steady_clock::now();
+        };
+        if (onLine) {
+            close(output[1]);
+            std::string pending;
+            char chunk[4096];
+            auto deliver = [&](bool flush) {
+                size_t end;
+                while ((end = pending.find_first_of("\r\n")) != std::string::npos) {
+                    if (end > 0) onLine(pending.substr(0, end));
+                    pending.erase(0, end + 1);
+                }
+                if (flush && !pending.empty()) onLine(pending);
+            };
+
+            while (true) {
+                sample();
+                struct pollfd ready {output[0], POLLIN, 0};
+                if (poll(&ready, 1, 100) > 0) {
+                    ssize_t n = read(output[0], chunk, sizeof(chunk));
+                    if (n > 0) {
+                        pending.append(chunk, n);
+                        deliver(false);
+                        continue;
+                    }
+                    if (n < 0 && errno == EINTR) continue;
+                    break;
+                }
+
+                // A daemon spawned by the build (sccache, gradle) can keep the pipe open
+                if (wait4(pid, &status, WNOHANG, &ru) == pid) {
+                    reaped = true;
+                    fcntl(output[0], F_SETFL, O_NONBLOCK);
+                    ssize_t n;
+                    while ((n = read(output[0], chunk, sizeof(chunk))) > 0) pending.append(chunk, n);
+                    break;
+                }
+            }
+            deliver(true);
+            close(output[0]);
+        }
+
+#ifdef __linux__
+        while (!reaped && usage) {
+            pid_t done = wait4(pid, &status, WNOHANG, &ru);
+            reaped = done == pid;
+            if (done < 0 && errno != EINTR) return -1;
+            if (!reaped) std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            sample();
+        }
+#endif
+        while (!reaped && wait4(pid, &status, 0, &ru) < 0) {
+            if (errno != EINTR) return -1;
+        }
+        if (usage) {
+            usage->cpuUserMs = ru.ru_utime.tv_sec * 1000L + ru.ru_utime.tv_usec / 1000;
+            usage->cpuSysMs = ru.ru_stime.tv_sec * 1000L + ru.ru_stime.tv_usec / 1000;
+#ifdef __APPLE__
+            usage->peakRssKb = ru.ru_maxrss / 1024;
+#else
+            usage->peakRssKb = std::max((long)ru.ru_maxrss, sampledRssKb);
+#endif
+            usage->blockIn = ru.ru_inblock;
+            usage->blockOut = ru.ru_oublock;
+            usage->ctxVoluntary = ru.ru_nvcsw;
+            usage->ctxInvoluntary = ru.ru_nivcsw;
+        }
+        return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+#endif
+    }
+
+    // Run a build step with the output lock released so project builds overlap
+    int runBuildCommand(ProjectInfo& proj, const std::string& cmd, std::unique_lock<std::mutex>& lock) {
+        ResourceUsage usage;
+        lock.unlock();
+#ifdef _WIN32
+        int result = runCommand(verboseMode ? cmd : cmd + QUIET_REDIRECT, &usage);
+#else
+        // Output goes to the slot's status line; verbose mode also prints it whole lines at a time
+        int slot = currentSlot;
+        int result = runCommand(cmd, &usage, [this, slot](const std::string& line) {
+            publishLine(slot, line);
+            if (verboseMode) {
+                std::lock_guard<std::mutex> outputLock(outputMutex);
+                std::cout << line << std::endl;
+            }
+        });
+#endif
+        lock.lock();
+        proj.stats.usage.add(usage);
+        return result;
+    }
+
+    // Rough bottleneck of a build from its CPU time, wall time, block I/O and memory
+    std::string classifyUsage(const ResourceUsage& usage, std::chrono::milliseconds wall) {
+        if (wall.count() <= 0) return "";
+
+        SystemLoad load;
+        long memoryLimitKb = readSystemLoad(load) ? load.memTotalKb / 4 : 2L * 1024 * 1024;
+        if (usage.peakRssKb > memoryLimitKb) return "memory-heavy";
+
+        double cpuRatio = (double)(usage.cpuUserMs + usage.cpuSysMs) / wall.count();
+        bool waitsOften = usage.ctxVoluntary > 2 * usage.ctxInvoluntary;
+        if (cpuRatio < 0.5 && (waitsOften || usage.blockIn + usage.blockOut > 0)) return "I/O-bound";
+        if (cpuRatio >= 0.8) return "CPU-bound";
+        return "mixed";
+    }
+
+    static std::string configSuffix(const ProjectInfo& proj) {
+        return proj.config.empty() ? "" : "@" + proj.config;
+    }
+
+    // Cache key prefix for per-build measurements; each --configs copy has its own
+    static std::string projectKey(const ProjectInfo& proj) {
+        return proj.path + configSuffix(proj);
+    }
+
+    // After a successful build: its input signature, and its time as either a
+    // rebuild (inputs changed) or a no-op build, the two estimates --plan uses.
+    // _lastBuilt (any configuration) orders --gc evictions
+    void recordInputs(const ProjectInfo& proj) {
+        if (proj.inputSig.empty()) return;
+        configCache[proj.path + "_lastBuilt"] = std::to_string((long long)std::time(nullptr));
+        std::string key = projectKey(proj);
+        auto previous = configCache.find(key + "_inputSig");
+        bool unchanged = previous != configCache.end() && previous->second == proj.inputSig;
+        if (!proj.restoredFromCache && proj.stats.totalTime.count() > 0) {
+            configCache[key + (unchanged ? "_noopMs" : "_rebuildMs")] = std::to_string(proj.stats.totalTime.count());
+        }
+        configCache[key + "_inputSig"] = proj.inputSig;
+    }
+
+    // Store the last measured resource usage next to the project's other cache entries
+    void recordUsage(const ProjectInfo& proj) {
+        const ResourceUsage& usage = proj.stats.usage;
+        if (usage.peakRssKb == 0) return;
+
+        configCache[projectKey(proj) + "_cpuUserMs"] = std::to_string(usage.cpuUserMs);
+        configCache[projectKey(proj) + "_cpuSysMs"] = std::to_string(usage.cpuSysMs);
+        configCache[projectKey(proj) + "_peakRssKb"] = std::to_string(usage.peakRssKb);
+        configCache[projectKey(proj) + "_blockIn"] = std::to_string(usage.blockIn);
+        configCache[projectKey(proj) + "_blockOut"] = std::to_string(usage.blockOut);
+        configCache[projectKey(proj) + "_ctxVoluntary"] = std::to_string(usage.ctxVoluntary);
+        configCache[projectKey(proj) + "_ctxInvoluntary"] = std::to_string(usage.ctxInvoluntary);
+
+        std::string profile = classifyUsage(usage, proj.stats.totalTime);
+        if (!profile.empty()) configCache[projectKey(proj) + "_profile"] = profile;
+    }
+
+    // Split "a,b,c" into trimmed, non-empty items
+    static std::vector<std::string> splitList(const std::string& text, char separator) {
+        std::vector<std::string> items;
+        std::stringstream ss(text);
+        std::string item;
+        while (std::getline(ss, item, separator)) {
+            item.erase(0, item.find_first_not_of(" \t"));
+            item.erase(item.find_last_not_of(" \t\r\n") + 1);
+            if (!item.empty()) items.push_back(item);
+        }
+        return items;
+    }
+
+    // Match a file name against a simple '*' / '?' wildcard pattern
+    static bool matchesPattern(const std::string& name, const std::string& pattern) {
+        size_t n = 0, p = 0, starP = std::string::npos, starN = 0;
+        while (n < name.size()) {
+            if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == name[n])) {
+                n++; p++;
+            } else if (p < pattern.size() && pattern[p] == '*') {
+                starP = p++;
+                starN = n;
+            } else if (starP != std::string::npos) {
+                p = starP + 1;
+                n = ++starN;
+            } else {
+                return false;
+            }
+        }
+        while (p < pattern.size() && pattern[p] == '*') p++;
+        return p == pattern.size();
+    }
+
+    // Project path relative to the scan root (stable across clones)
+    std::string relativeProjectPath(const ProjectInfo& proj) {
+        std::error_code ec;
+        fs::path rel = fs::relative(proj.path, fs::absolute(customPath), ec);
+        if (ec || rel.empty()) return proj.path;
+        return rel.generic_string();
+    }
+
+    // 64-bit FNV-1a, used for stable directory and cache keys
+    static std::string hashString(const std::string& text) {
+        unsigned long long hash = 1469598103934665603ULL;
+        for (unsigned char c : text) {
+            hash ^= c;
+            hash *= 1099511628211ULL;
+        }
+        std::ostringstream hex;
+        hex << std::hex << std::setw(16) << std::setfill('0') << hash;
+        return hex.str();
+    }
+
+    // Content hash of a file; "" when it cannot be read
+    static std::string hashFile(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) return "";
+        std::stringstream content;
+        content << file.rdbuf();
+        return hashString(content.str());
+    }
+
+    // "512K", "500M", "20G" or plain bytes; 0 when invalid
+    static unsigned long long parseSize(const std::string& text) {
+        char* end = nullptr;
+        double value = std::strtod(text.c_str(), &end);
+        if (end == text.c_str() || value <= 0) return 0;
+        switch (std::toupper(static_cast<unsigned char>(*end))) {
+            case 'K': value *= 1024.0; break;
+            case 'M': value *= 1024.0 * 1024.0; break;
+            case 'G': value *= 1024.0 * 1024.0 * 1024.0; break;
+            case 'T': value *= 1024.0 * 1024.0 * 1024.0 * 1024.0; break;
+            case '\0': break;
+            default: return 0;
+        }
+        return static_cast<unsigned long long>(value);
+    }
+
+    // Per-user cache directory shared by all focal-run invocations
+    static std::string userCacheDir() {
+#ifdef _WIN32
+        const char* base = getenv("LOCALAPPDATA");
+        return std::string(base ? base : ".") + "\\focal-run";
+#else
+        const char* xdg = getenv("XDG_CACHE_HOME");
+        if (xdg && *xdg) return std::string(xdg) + "/focal-run";
+        const char* home = getenv("HOME");
+        return std::string(home ? home : "/tmp") + "/.cache/focal-run";
+#endif
+    }
+
+    static double median(std::vector<double> values) {
+        if (values.empty()) return 0.0;
+        std::sort(values.begin(), values.end());
+        size_t mid = values.size() / 2;
+        return values.size() % 2 ? values[mid] : (values[mid - 1] + values[mid]) / 2.0;
+    }
+
+    static double mean(const std::vector<double>& values) {
+        if (values.empty()) return 0.0;
+        double sum = 0.0;
+        for (double v : values) sum += v;
+        return sum / values.size();
+    }
+
+    static double variance(const std::vector<double>& values) {
+        if (values.size() < 2) return 0.0;
+        double m = mean(values);
+        double sum = 0.0;
+        for (double v : values) sum += (v - m) * (v - m);
+        return sum / (values.size() - 1);
+    }
+
+    // Regularized incomplete beta function I_x(a, b), Lentz's continued fraction
+    static double incompleteBeta(double a, double b, double x) {
+        if (x <= 0.0) return 0.0;
+        if (x >= 1.0) return 1.0;
+        if (x > (a + 1.0) / (a + b + 2.0)) {
+            return 1.0 - incompleteBeta(b, a, 1.0 - x);
+        }
+
+        double lbeta = std::lgamma(a + b) - std::lgamma(a) - std::lgamma(b);
+        double front = std::exp(std::log(x) * a + std::log(1.0 - x) * b + lbeta) / a;
+
+        double f = 1.0, c = 1.0, d = 0.0;
+        for (int i = 0; i <= 200; ++i) {
+            int m = i / 2;
+            double numerator;
+            if (i == 0) {
+                numerator = 1.0;
+            } else if (i % 2 == 0) {
+                numerator = (m * (b - m) * x) / ((a + 2.0 * m - 1.0) * (a + 2.0 * m));
+            } else {
+                numerator = -((a + m) * (a + b + m) * x) / ((a + 2.0 * m) * (a + 2.0 * m + 1.0));
+            }
+
+            d = 1.0 + numerator * d;
+            if (std::fabs(d) < 1e-30) d = 1e-30;
+            d = 1.0 / d;
+            c = 1.0 + numerator / c;
+            if (std::fabs(c) < 1e-30) c = 1e-30;
+
+            double cd = c * d;
+            f *= cd;
+            if (std::fabs(1.0 - cd) < 1e-10) break;
+        }
+        return front * (f - 1.0);
+    }
+
+    // Two-sided p-value of Welch's t-test between two samples
+    static double welchPValue(const std::vector<double>& a, const std::vector<double>& b) {
+        if (a.size() < 2 || b.size() < 2) return 1.0;
+
+        double va = variance(a) / a.size();
+        double vb = variance(b) / b.size();
+        double diff = mean(b) - mean(a);
+        if (va + vb <= 0.0) return diff == 0.0 ? 1.0 : 0.0;
+
+        double t = diff / std::sqrt(va + vb);
+        double df = (va + vb) * (va + vb) /
+                    (va * va / (a.size() - 1) + vb * vb / (b.size() - 1));
+        return incompleteBeta(df / 2.0, 0.5, df / (df + t * t));
+    }
+
+    // Check Visual Studio installation
+    bool checkVisualStudioInstalled() {
+#ifdef _WIN32
+        std::vector<std::string> vsPaths = {
+            "C:\\Program Files\\Microsoft Visual Studio\\2022\\Community",
+            "C:\\Program Files\\Microsoft Visual Studio\\2022\\Professional",
+            "C:\\Program Files\\Microsoft Visual Studio\\2022\\Enterprise",
+            "C:\\Program Files (x86)\\Microsoft Visual Studio\\2019\\Community",
+            "C:\\Program Files (x86)\\Microsoft Visual Studio\\2019\\Professional",
+            "C:\\Program Files (x86)\\Microsoft Visual Studio\\2019\\Enterprise"
+        };
+
+        for (const auto& path : vsPaths) {
+            if (fs::exists(path)) {
+                return true;
+            }
+        }
+
+        if (isCommandAvailable("vswhere")) {
+            return true;
+        }
+#endif
+        return false;
+    }
+
+    // Detect generator from CMakeLists.txt
+    std::string detectGenerator(const std::string& projectPath) {
+        std::string cmakelists = projectPath + "/CMakeLists.txt";
+        std::ifstream file(cmakelists);
+        std::string line;
+        std::string detectedGen = "";
+
+        if (!file.is_open()) {
+            return "";
+        }
+
+        while (std::getline(file, line)) {
+            line.erase(0, line.find_first_not_of(" \t"));
+
+            if (line.find("# Focal-Generator:") == 0) {
+                detectedGen = line.substr(18);
+                detectedGen.erase(0, detectedGen.find_first_not_of(" \t"));
+                detectedGen.erase(detectedGen.find_last_not_of(" \t\n\r") + 1);
+
+                if (detectedGen == "VS162019") detectedGen = "Visual Studio 16 2019";
+                else if (detectedGen == "VS172022") detectedGen = "Visual Studio 17 2022";
+                else if (detectedGen == "MinGW") detectedGen = "MinGW Makefiles";
+                else if (detectedGen == "Ninja") detectedGen = "Ninja";
+                else if (detectedGen == "Make") detectedGen = "Unix Makefiles";
+
+                break;
+            }
+
+            if (line.find("CMAKE_GENERATOR") != std::string::npos) {
+                size_t start = line.find("\"");
+                size_t end = line.rfind("\"");
+                if (start != std::string::npos && end != std::string::npos && start != end) {
+                    detectedGen = line.substr(start + 1, end - start - 1);
+                    break;
+                }
+            }
+        }
+
+        file.close();
+        return detectedGen;
+    }
+
+    // Select generator automatically
+    std::string selectGenerator() {
+        if (isCommandAvailable("ninja")) {
+            return "Ninja";
+        }
+        if (isCommandAvailable("mingw32-make")) {
+            return "MinGW Makefiles";
+        }
+        if (isCommandAvailable("make")) {
+            return "Unix Makefiles";
+        }
+
+#ifdef _WIN32
+        return "Visual Studio 17 2022";
+#else
+        return "Unix Makefiles";
+#endif
+    }
+
+    // Determine build system
+    void determineBuildSystem(ProjectInfo& proj) {
+        std::string cacheKey = proj.path + "_generator";
+        std::string detected;
+
+        if (proj.buildSystem == BuildSystem::Rust) {
+            proj.detectedGenerator = "Cargo";
+            configCache[cacheKey] = proj.detectedGenerator;
+            return;
+        }
+
+        std::map<std::string, std::string> tune = tuneOptions(proj);
+        auto tuned = tune.find("generator");
+        if (tuned != tune.end()) {
+            detected = tuned->second;
+            if (verboseMode) {
+                std::cout << colorize("  [TUNE]", Color::CYAN)
+                         << " Using tuned generator: " << detected << std::endl;
+            }
+        } else if (configCache.count(cacheKey)) {
+            detected = configCache[cacheKey];
+            if (verboseMode) {
+                std::cout << colorize("  [CACHE]", Color::CYAN) 
+                         << " Using cached generator: " << detected << std::endl;
+            }
+        } else {
+            detected = detectGenerator(proj.path);
+        }
+
+        if (!detected.empty()) {
+            proj.detectedGenerator = detected;
+            configCache[cacheKey] = detected;
+            if (verboseMode && !configCache.count(cacheKey)) {
+                std::cout << colorize("  [DETECT]", Color::BLUE) 
+                         << " Found generator: " << detected << std::endl;
+            }
+        } else {
+            proj.detectedGenerator = selectGenerator();
+            configCache[cacheKey] = proj.detectedGenerator;
+            if (verboseMode) {
+                std::cout << colorize("  [AUTO]", Color::MAGENTA) 
+                         << " Selected generator: " << proj.detectedGenerator << std::endl;
+            }
+        }
+    }
+
+    // Show progress bar
+    void showProgressBar(int current, int total, const std::string& status = "") {
+        if (!showProgress) return;
+        if (dashboardActive) {
+            dashboardDone = current;
+            dashboardTotal = total;
+            return;
+        }
+        if (verboseMode) return;
+
+        std::lock_guard<std::mutex> lock(outputMutex);
+#ifndef _WIN32
+        // Redirected output (CI logs): one plain line per finished project
+        if (!isatty(STDOUT_FILENO)) {
+            std::cout << "[" << current << "/" << total << "] " << status << std::endl;
+            return;
+        }
+#endif
+        int barWidth = 50;
+        float progress = (float)current / total;
+        int pos = barWidth * progress;
+
+        std::cout << "\r[";
+        for (int i = 0; i < barWidth; ++i) {
+            if (i < pos) std::cout << "=";
+            else if (i == pos) std::cout << ">";
+            else std::cout << " ";
+        }
+        std::cout << "] " << int(progress * 100.0) << "% (" 
+                  << current << "/" << total << ")";
+        
+        if (!status.empty()) {
+            std::cout << " " << status;
+        }
+        
+        std::cout << std::flush;
+
+        if (current == total) {
+            std::cout << std::endl;
+        }
+    }
+
+    static long long steadyMillis() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void emitEvent(BuildEvent::Type type, size_t index, const std::string& text = "") {
+        if (!eventHandler) return;
+        BuildEvent event;
+        event.type = type;
+        event.project = &projects[index];
+        event.text = text;
+        std::lock_guard<std::mutex> lock(eventMutex);
+        eventHandler(event);
+    }
+
+    // Seqlock write of a slot's last output line; one writer per slot at a time
+    void publishLine(int slot, const std::string& text) {
+        if (slot < 0 || (size_t)slot >= slotCount) return;
+        SlotStatus& status = slots[slot];
+        int project = status.project.load();
+        if (project >= 0 && !text.empty()) emitEvent(BuildEvent::Type::Output, project, text);
+        unsigned version = status.lineVersion.load(std::memory_order_relaxed);
+        status.lineVersion.store(version + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        size_t length = std::min(text.size(), status.line.size() - 1);
+        for (size_t i = 0; i < length; ++i) status.line[i].store(text[i], std::memory_order_relaxed);
+        status.line[length].store('\0', std::memory_order_relaxed);
+        status.lineVersion.store(version + 2, std::memory_order_release);
+    }
+
+    std::string readSlotLine(const SlotStatus& status) {
+        for (int attempt = 0; attempt < 4; ++attempt) {
+            unsigned before = status.lineVersion.load(std::memory_order_acquire);
+            if (before & 1) continue;
+            std::string text;
+            for (const auto& c : status.line) {
+                char value = c.load(std::memory_order_relaxed);
+                if (value == '\0') break;
+                text += value;
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (status.lineVersion.load(std::memory_order_relaxed) == before) return text;
+        }
+        return "";
+    }
+
+    // "0-3,8,10-11" (sysfs cpulist format) to CPU numbers and back
+    static std::vector<int> parseCpuList(const std::string& list) {
+        std::vector<int> cpus;
+        for (const auto& range : splitList(list, ',')) {
+            size_t dash = range.find('-');
+            int first = std::atoi(range.c_str());
+            int last = dash == std::string::npos ? first : std::atoi(range.c_str() + dash + 1);
+            for (int cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+        }
+        return cpus;
+    }
+
+    static std::string formatCpuList(const std::vector<int>& cpus) {
+        std::string text;
+        for (size_t i = 0; i < cpus.size(); ) {
+            size_t j = i;
+            while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) ++j;
+            if (!text.empty()) text += ",";
+            text += std::to_string(cpus[i]);
+            if (j > i) text += "-" + std::to_string(cpus[j]);
+            i = j + 1;
+        }
+        return text;
+    }
+
+    // CPU sets for --pin-slots and --numa. Slots are dealt round-robin over NUMA
+    // nodes (or all allowed CPUs as one group); with --pin-slots each slot then
+    // gets a contiguous share of its group, so neighbouring cores share caches.
+    // Memory stays local through first-touch allocation on the pinned CPUs
+    void planSlotPlacement(size_t buildSlots) {
+        slotCpus.clear();
+        laneUsers.clear();
+#ifdef __linux__
+        if ((!pinSlotsMode && !numaMode) || buildSlots == 0) return;
+        cpu_set_t allowed;
+        if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) return;
+
+        std::vector<std::vector<int>> groups;
+        if (numaMode) {
+            std::map<int, std::vector<int>> nodes;
+            std::error_code ec;
+            for (const auto& entry : fs::directory_iterator("/sys/devices/system/node", ec)) {
+                std::string name = entry.path().filename().string();
+                if (name.rfind("node", 0) != 0 || name.size() == 4 || !std::isdigit((unsigned char)name[4])) continue;
+                std::ifstream cpulist(entry.path() / "cpulist");
+                std::string line;
+                if (!std::getline(cpulist, line)) continue;
+                std::vector<int> cpus;
+                for (int cpu : parseCpuList(line)) {
+                    if (cpu >= 0 && cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed)) cpus.push_back(cpu);
+                }
+                if (!cpus.empty()) nodes[std::atoi(name.c_str() + 4)] = cpus;
+            }
+            for (auto& node : nodes) groups.push_back(node.second);
+            if (groups.size() < 2 && verboseMode) {
+                std::cout << colorize("  [PIN]", Color::MAGENTA) << " Single NUMA node, --numa has no effect" << std::endl;
+            }
+        }
+        if (groups.empty()) {
+            groups.emplace_back();
+            for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+                if (CPU_ISSET(cpu, &allowed)) groups.back().push_back(cpu);
+            }
+        }
+        if (groups.size() < 2 && !pinSlotsMode) return;
+
+        slotCpus.resize(buildSlots);
+        for (size_t slot = 0; slot < buildSlots; ++slot) {
+            size_t group = slot % groups.size();
+            const std::vector<int>& cpus = groups[group];
+            if (!pinSlotsMode) {
+                slotCpus[slot] = cpus;
+                continue;
+            }
+            size_t slotsInGroup = (buildSlots - group + groups.size() - 1) / groups.size();
+            size_t shares = std::min(slotsInGroup, cpus.size());
+            size_t share = (slot / groups.size()) % shares;
+            slotCpus[slot].assign(cpus.begin() + share * cpus.size() / shares,
+                                  cpus.begin() + (share + 1) * cpus.size() / shares);
+        }
+
+        laneUsers.assign(slotCpus.size(), 0);
+        if (verboseMode) {
+            for (size_t slot = 0; slot < slotCpus.size(); ++slot) {
+                std::cout << colorize("  [PIN]", Color::MAGENTA) << " Lane " << slot << ": CPUs "
+                         << formatCpuList(slotCpus[slot])
+                         << (groups.size() > 1 ? " (node group " + std::to_string(slot % groups.size()) + ")" : "")
+                         << std::endl;
+            }
+        }
+#else
+        (void)buildSlots;
+#endif
+    }
+
+    // Claim the build lane (CPU set) with the fewest threads on it and move the
+    // calling thread there; the builds it forks inherit it. Lanes are separate
+    // from dashboard slots, which are claimed in another order and also cover
+    // remote builds. Returns -1 when nothing is pinned
+    int claimLane() {
+#ifdef __linux__
+        if (slotCpus.empty()) return -1;
+        int lane;
+        {
+            std::lock_guard<std::mutex> lock(laneMutex);
+            lane = (int)(std::min_element(laneUsers.begin(), laneUsers.end()) - laneUsers.begin());
+            laneUsers[lane]++;
+        }
+        cpu_set_t mask;
+        CPU_ZERO(&mask);
+        for (int cpu : slotCpus[lane]) CPU_SET(cpu, &mask);
+        sched_setaffinity(0, sizeof(mask), &mask);
+        return lane;
+#else
+        return -1;
+#endif
+    }
+
+    // Hand a lane back once the build or test on it has finished
+    void releaseLane(int lane) {
+        if (lane < 0) return;
+        std::lock_guard<std::mutex> lock(laneMutex);
+        laneUsers[lane]--;
+    }
+
+    // --priority: background runs niced, in the idle I/O class and as SCHED_BATCH,
+    // so an interactive build on the same host gets cores and disk first.
+    // Set on the main thread before any other starts; threads and children inherit it
+    void applyPriority() {
+        if (priorityLane.empty()) return;
+        bool background = priorityLane == "background";
+#ifdef _WIN32
+        SetPriorityClass(GetCurrentProcess(), background ? BELOW_NORMAL_PRIORITY_CLASS : ABOVE_NORMAL_PRIORITY_CLASS);
+#else
+        errno = 0;
+        int niceValue = getpriority(PRIO_PROCESS, 0);
+        if (errno == 0) {
+            // Raising priority needs privileges (or RLIMIT_NICE); interactive then keeps the current value
+            int target = background ? std::min(niceValue + 10, 19) : std::max(niceValue - 5, -20);
+            if (setpriority(PRIO_PROCESS, 0, target) != 0 && verboseMode) {
+                std::cout << colorize("  [PRIORITY]", Color::YELLOW) << " Cannot change nice value "
+                         << niceValue << " to " << target << std::endl;
+            }
+        }
+#ifdef __linux__
+        struct sched_param param {};
+        if (background) sched_setscheduler(0, SCHED_BATCH, &param);
+#ifdef SYS_ioprio_set
+        // IOPRIO_WHO_PROCESS = 1; class in the top bits: 3 idle, 2 best-effort (level 0 highest)
+        syscall(SYS_ioprio_set, 1, 0, background ? (3 << 13) : (2 << 13));
+#endif
+#endif
+        if (verboseMode) {
+            std::cout << colorize("  [PRIORITY]", Color::CYAN) << " " << priorityLane << " lane, nice "
+                     << getpriority(PRIO_PROCESS, 0) << std::endl;
+        }
+#endif
+    }
+
+    // Claim a free slot for a project and phase; returns -1 when slots are not tracked
+    int claimSlot(size_t project, const std::string& phase, long estimateMs) {
+        for (size_t i = 0; i < slotCount; ++i) {
+            if (slots[i].project.load() >= 0) continue;
+            slots[i].estimateMs = estimateMs;
+            slots[i].startedMs = steadyMillis();
+            slots[i].phase = phaseIndex(phase);
+            publishLine(i, "");
+            slots[i].project = (int)project;
+            return (int)i;
+        }
+        return -1;
+    }
+
+    static const std::vector<std::string>& phaseNames() {
+        static const std::vector<std::string> names = {"build", "configure", "cargo", "make", "remote", "test"};
+        return names;
+    }
+
+    static int phaseIndex(const std::string& phase) {
+        const auto& names = phaseNames();
+        return (int)(std::find(names.begin(), names.end(), phase) - names.begin()) % names.size();
+    }
+
+    // Redraw the dashboard below the scrolling output; caller holds outputMutex
+    void drawDashboard(DashboardBuf& buf, long long runStartMs) {
+        int width = 100;
+#ifndef _WIN32
+        struct winsize size {};
+        if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0 && size.ws_col > 20) width = size.ws_col;
+#endif
+        auto fit = [width](std::string text) {
+            if ((int)text.size() > width - 1) text.resize(width - 1);
+            return text;
+        };
+
+        size_t done = dashboardDone, total = std::max<size_t>(1, dashboardTotal);
+        int barWidth = 30;
+        int pos = (int)(barWidth * done / total);
+        std::ostringstream header;
+        header << "[" << std::string(pos, '=') << (pos < barWidth ? ">" : "")
+               << std::string(std::max(0, barWidth - pos - 1), ' ') << "] " << done << "/" << total
+               << "  " << std::fixed << std::setprecision(1) << (steadyMillis() - runStartMs) / 1000.0 << "s";
+
+        std::vector<std::string> rows = {colorize(fit(header.str()), Color::BOLD)};
+        for (size_t i = 0; i < slotCount; ++i) {
+            int project = slots[i].project.load();
+            if (project < 0) continue;
+
+            std::ostringstream row;
+            double elapsed = (steadyMillis() - slots[i].startedMs.load()) / 1000.0;
+            row << "  " << std::left << std::setw(20) << projects[project].name.substr(0, 20) << " "
+                << std::setw(9) << phaseNames()[slots[i].phase.load()] << std::right << std::fixed
+                << std::setprecision(1) << std::setw(6) << elapsed << "s";
+            long estimate = slots[i].estimateMs.load();
+            if (estimate > 0) row << " / ~" << estimate / 1000.0 << "s";
+            std::string text = readSlotLine(slots[i]);
+            std::string prefix = row.str();
+            rows.push_back(colorize(prefix, Color::CYAN) + fit("  " + text).substr(0, std::max(0, width - 1 - (int)prefix.size())));
+        }
+
+        buf.erase();
+        std::string frame;
+        for (const auto& row : rows) frame += "\033[2K" + row + "\n";
+        buf.target->sputn(frame.data(), frame.size());
+        buf.target->pubsync();
+        dashboardLines = (int)rows.size();
+    }
+
+public:
+    FocalRun(int argc, char* argv[]) {
+        selfExecutable = argv[0];
+#ifdef __linux__
+        std::error_code ec;
+        fs::path exe = fs::read_symlink("/proc/self/exe", ec);
+        if (!ec) selfExecutable = exe.string();
+#endif
+        configure(std::vector<std::string>(argv + 1, argv + argc));
+    }
+
+    // Embedded use: the command-line options, without the program name.
+    // Worker and --single-project children are started as "focal-run" from PATH
+    explicit FocalRun(const std::vector<std::string>& args) {
+        configure(args);
+    }
+
+    // Handler for build() progress; called from build threads, one call at a time
+    void onEvent(std::function<void(const BuildEvent&)> handler) {
+        eventHandler = std::move(handler);
+    }
+
+    // Projects under --path after deduplication and the selection options
+    // (--<name>, --rust, --changed-since, --shard, --configs). Scanned on the
+    // first call and kept; rescan picks up projects added since
+    const std::vector<ProjectInfo>& discover(bool rescan = false) {
+        if (indexed && !rescan) return projectIndex;
+        loadConfigCache();
+        projects.clear();
+        nothingToBuild = false;
+        scanProjects();
+        deduplicateProjects();
+        filterProjects();
+        dependencyGraph.clear();
+        analyzeDependencies();
+        projectIndex = projects;
+        indexed = true;
+        return projectIndex;
+    }
+
+    // Indexed project by name or path relative to --path, or nullptr
+    const ProjectInfo* findProject(const std::string& name) {
+        for (const auto& proj : discover()) {
+            if (proj.name == name || relativeProjectPath(proj) == name) return &proj;
+        }
+        return nullptr;
+    }
+
+    // What build() would do for the same selection, without building
+    BuildPlan plan(const std::vector<std::string>& names = {}) {
+        selectProjects(names);
+        prepareBuildRoot(false);
+        return computePlan();
+    }
+
+    // Build the discovered projects, or those named, with the options given at
+    // construction. Each call starts from the index, so results do not carry over
+    const std::vector<ProjectInfo>& build(const std::vector<std::string>& names = {}) {
+        selectProjects(names);
+        prepareBuildRoot(!cleanMode);
+        buildAllProjects();
+        enforceBuildRootQuota(true);
+        saveConfigCache();
+        return projects;
+    }
+
+    // Command-line entry point; returns the process exit code
+    int run() {
+        if (helpMode) {
+            printHelp();
+            return 0;
+        }
+
+        if (scanMode) {
+            printProjects();
+            return 0;
+        }
+
+        if (selfBenchMode) {
+            runSelfBench();
+            return 0;
+        }
+
+        applyPriority();
+
+        if (!mergeReports.empty()) {
+            return mergeReportFiles() ? 0 : 1;
+        }
+
+        if (workerMode) {
+            runWorker();
+            return 0;
+        }
+
+        loadConfigCache();
+
+        if (checkMode) {
+            checkDependencies();
+            return 0;
+        }
+
+        if (buildMode && !singleFile.empty()) {
+            buildSingleFile(singleFile);
+            if (timeReportMode) printTimeReport();
+            return benchRegressed ? 1 : 0;
+        }
+
+        if (buildMode) {
+            scanAndBuildSingleCppFiles();
+            if (timeReportMode) printTimeReport();
+            return benchRegressed ? 1 : 0;
+        }
+
+        scanProjects();
+
+        deduplicateProjects();
+
+        filterProjects();
+        if (nothingToBuild) return 0;
+
+        prepareBuildRoot(!planMode && !cleanMode && gcBudget == 0);
+
+        if (planMode) {
+            printPlan();
+            return 0;
+        }
+
+        if (gcBudget > 0) {
+            collectGarbage();
+            return 0;
+        }
+
+        if (tuneMode) {
+            if (projects.empty()) throw FocalRunError("No projects found!");
+            tuneProjects();
+            return 0;
+        }
+
+        if (cleanMode && allMode && !changedMode) {
+            cleanAllBuildDirs();
+        } else {
+            if (projects.empty()) throw FocalRunError("No projects found!");
+
+            if (verboseMode) {
+                std::cout << "\n" << colorize("=== Focal-RUN Build Tool ===", Color::BOLD + Color::CYAN) << std::endl;
+                std::cout << "Mode: " << colorize(cleanMode ? "Clean" : buildType, Color::YELLOW) << std::endl;
+                std::cout << "Rebuild: " << (rebuildMode ? colorize("Yes", Color::GREEN) : colorize("No", Color::RED)) << std::endl;
+                std::cout << "Path: " << customPath << std::endl;
+                std::cout << "Projects: " << colorize(std::to_string(projects.size()), Color::BOLD) << std::endl;
+                std::cout << "Max Concurrent: " << maxConcurrentBuilds << " threads" << std::endl << std::endl;
+            }
+
+            buildAllProjects();
+            enforceBuildRootQuota(true);
+        }
+
+        saveConfigCache();
+        printReport();
+
+        if (timeReportMode && !cleanMode) {
+            printTimeReport();
+        }
+
+        if (!reportFile.empty() && !(cleanMode && allMode && !changedMode)) {
+            writeReport();
+        }
+
+        // A coordinator reads the worker's exit code as the build result
+        if (singleProjectMode && std::any_of(projects.begin(), projects.end(),
+                                             [](const ProjectInfo& p) { return !p.success; })) {
+            return 1;
+        }
+
+        if (benchMode && !cleanMode) {
+            std::vector<BenchTarget> benchTargets;
+            for (const auto& proj : projects) {
+                if (!proj.success) continue;
+                std::vector<BenchTarget> found = discoverBenchTargets(proj);
+                benchTargets.insert(benchTargets.end(), found.begin(), found.end());
+            }
+            runBenchmarks(benchTargets);
+        }
+
+        if (artifactStatsMode && !cleanMode) {
+            std::vector<ArtifactStats> artifacts;
+            for (const auto& proj : projects) {
+                if (!proj.success) continue;
+                std::vector<ArtifactStats> found = discoverArtifacts(proj);
+                artifacts.insert(artifacts.end(), found.begin(), found.end());
+            }
+            runArtifactStats(artifacts);
+        }
+        return benchRegressed ? 1 : 0;
+    }
+
+private:
+
+    void configure(const std::vector<std::string>& args) {
+        enableColorOutput();
+        parseArguments(args);
+        
+        // Set max concurrent builds based on hardware
+        unsigned int hwThreads = std::max(1u, std::thread::hardware_concurrency());
+        maxConcurrentBuilds = std::min((size_t)hwThreads, maxConcurrentBuilds);
+
+        // The adaptive controller may go above the default cap, never above --jobs
+        adaptiveCeiling = jobsExplicit ? maxConcurrentBuilds : std::max((size_t)hwThreads, maxConcurrentBuilds);
+
+        // Configure steps barely use more than one core, so by default one per hardware thread
+        if (configureJobs == 0) configureJobs = hwThreads;
+        if (workerSlots == 0) workerSlots = hwThreads;
+    }
+
+    // The working set for plan() and build(): indexed projects, all or by name
+    void selectProjects(const std::vector<std::string>& names) {
+        discover();
+        projects.clear();
+        for (const auto& proj : projectIndex) {
+            bool named = names.empty() || std::find(names.begin(), names.end(), proj.name) != names.end() ||
+                         std::find(names.begin(), names.end(), relativeProjectPath(proj)) != names.end();
+            if (named) projects.push_back(proj);
+        }
+        for (const auto& name : names) {
+            if (!findProject(name)) throw FocalRunError("Project '" + name + "' not found!");
+        }
+        if (projects.empty()) throw FocalRunError("No projects found!");
+    }
+
+    void printHelp() {
+        std::cout << "\n" << colorize(std::string(70, '='), Color::BOLD) << std::endl;
+        std::cout << colorize("  FOCAL-RUN - Multi-Platform Build Tool", Color::BOLD + Color::CYAN) << std::endl;
+        std::cout << colorize(std::string(70, '='), Color::BOLD) << "\n" << std::endl;
+
+        std::cout << colorize("DESCRIPTION:", Color::BOLD) << std::endl;
+        std::cout << "  Focal-Run automates building CMake, Makefile, and Rust projects.\n"
+                  << "  Supports parallel builds, auto-detection, and caching.\n" << std::endl;
+
+        std::cout << colorize("USAGE:", Color::BOLD) << std::endl;
+        std::cout << "  focal-run [OPTIONS] [PROJECT_NAME]\n" << std::endl;
+
+        std::cout << colorize("COMMANDS:", Color::BOLD) << std::endl;
+        std::cout << "  --scan                    Display all available projects" << std::endl;
+        std::cout << "  --check                   Check build tools availability" << std::endl;
+        std::cout << "  --self-bench              Measure focal-run's own overhead on a synthetic tree" << std::endl;
+        std::cout << "  --self-bench-dirs=<n>     Directories in the synthetic tree (default: 3000)" << std::endl;
+        std::cout << "  --self-bench-projects=<n> Stub projects in the synthetic tree (default: 300)" << std::endl;
+        std::cout << "  --help, -h                Show this help message" << std::endl << std::endl;
+
+        std::cout << colorize("RUST SPECIFIC:", Color::BOLD) << std::endl;
+        std::cout << "  --rust                    Filter to Rust projects only" << std::endl;
+        std::cout << "  --test                    Run CTest / cargo test binaries after building" << std::endl;
+        std::cout << "  --no-test-cache           Re-run tests whose binaries and inputs did not change" << std::endl;
+        std::cout << "  --doc                     Generate documentation" << std::endl;
+        std::cout << "  --run                     Run with cargo run" << std::endl;
+        std::cout << "  --cargo-check             Check project without building" << std::endl;
+        std::cout << "  --shared-target[=<dir>]   Share one target dir per toolchain across projects" << std::endl;
+        std::cout << "  --sccache                 Shared target dir plus RUSTC_WRAPPER=sccache" << std::endl << std::endl;
+
+        std::cout << colorize("BENCHMARKS:", Color::BOLD) << std::endl;
+        std::cout << "  --bench                   Build, then run benchmarks and compare to history" << std::endl;
+        std::cout << "  --bench-reps=<n>          Measured repetitions per benchmark (default: 5)" << std::endl;
+        std::cout << "  --bench-pattern=<glob>    Benchmark executable pattern (default: *bench*)" << std::endl;
+        std::cout << "  --bench-label=<label>     CTest label for benchmarks (default: bench)" << std::endl;
+        std::cout << "  --bench-cpu=<n>           Pin benchmarks to CPU n (default: last CPU)" << std::endl;
+        std::cout << "  --bench-tag=<id>          Name of this run in the history (default: timestamp)" << std::endl;
+        std::cout << "  --bench-baseline=<id>     Compare against a tagged run (default: previous)" << std::endl;
+        std::cout << "  --bench-threshold=<pct>   Minimum slowdown reported as regression (default: 5)" << std::endl;
+        std::cout << "  --artifact-stats          Track binary sizes and startup time against the last build" << std::endl;
+        std::cout << "  --artifact-runs=<n>       Warm startup runs per executable (default: 5)" << std::endl;
+        std::cout << "  --artifact-threshold=<pct> Minimum growth reported as regression (default: 5)" << std::endl << std::endl;
+
+        std::cout << colorize("BUILD OPTIONS:", Color::BOLD) << std::endl;
+        std::cout << "  --debug                   Build in Debug mode" << std::endl;
+        std::cout << "  --release                 Build in Release mode (default)" << std::endl;
+        std::cout << "  --configs=<a,b>           Build several configurations concurrently (e.g. Debug,Release)" << std::endl;
+        std::cout << "  --rebuild                 Clean and rebuild" << std::endl;
+        std::cout << "  --clean                   Clean build directories" << std::endl;
+        std::cout << "  --gc=<size>               Trim build dirs to a disk budget, least recently built first" << std::endl;
+        std::cout << "  --all                     Apply to all projects" << std::endl;
+        std::cout << "  --verbose                 Show detailed output" << std::endl;
+        std::cout << "  --no-color                Disable colored output" << std::endl;
+        std::cout << "  --path=<path>             Custom path to scan (default: .)" << std::endl;
+        std::cout << "  --jobs=<n>                Max concurrent builds (default: CPUs up to 8, adaptive up to CPUs)" << std::endl;
+        std::cout << "  --global-jobs=<n>         Builds at once across all focal-run processes on this host" << std::endl;
+        std::cout << "  --no-adaptive             Keep a fixed slot count (no memory/load control)" << std::endl;
+        std::cout << "  --configure-jobs=<n>      Max concurrent CMake configure steps (default: CPUs)" << std::endl;
+        std::cout << "  --pin-slots               Pin each build slot to its own share of the CPUs (Linux)" << std::endl;
+        std::cout << "  --numa                    Spread build slots over NUMA nodes, each kept on its node (Linux)" << std::endl;
+        std::cout << "  --priority=<lane>         interactive or background: CPU and I/O priority of all builds" << std::endl;
+        std::cout << "  --ninja-graph             Build all Ninja CMake projects in one Ninja graph" << std::endl;
+        std::cout << "  --plan                    Show what would rebuild, the critical path and the makespan" << std::endl;
+        std::cout << "  --tune                    Time generator, -j, linker, unity and PCH options; keep the fastest" << std::endl;
+        std::cout << "  --time-report             Rank slowest TUs, headers and templates (-ftime-trace/-ftime-report)" << std::endl;
+        std::cout << "  --changed-since=<ref>     Only projects changed since a git ref, plus dependents" << std::endl;
+        std::cout << "  --changed-files=<a,b>     Only projects owning these files, plus dependents" << std::endl;
+        std::cout << "  --shard=<i>/<n>           Build shard i of n, balanced by recorded build times" << std::endl;
+        std::cout << "  --shard-timings=<file>    Report with the build times used for sharding" << std::endl;
+        std::cout << "  --report=<file>           Write a report file (default for shards: .focal-run-report-<i>of<n>)" << std::endl;
+        std::cout << "  --merge-reports=<a,b>     Combine shard reports into one build report" << std::endl;
+        std::cout << "  --artifact-cache[=<dir>]  Restore build outputs of unchanged projects from a local store" << std::endl;
+        std::cout << "  --artifact-cache-size=<n> Store size limit, e.g. 500M, 20G (default: 10G)" << std::endl;
+        std::cout << "  --build-root=<dir>        Build outside the source tree, e.g. /dev/shm or local NVMe" << std::endl;
+        std::cout << "  --build-root-quota=<n>    Evict least recently used build dirs above this size" << std::endl << std::endl;
+
+        std::cout << colorize("DISTRIBUTED:", Color::BOLD) << std::endl;
+        std::cout << "  --worker[=<port>]         Serve builds for a coordinator (default port: 7420)" << std::endl;
+        std::cout << "  --worker-slots=<n>        Builds a worker runs at once (default: CPUs)" << std::endl;
+        std::cout << "  --worker-bind=<addr>      Address a worker listens on (default: 127.0.0.1)" << std::endl;
+        std::cout << "  --worker-token=<secret>   Shared secret between coordinator and workers" << std::endl;
+        std::cout << "                            (default: $FOCAL_RUN_WORKER_TOKEN)" << std::endl;
+        std::cout << "  --workers=<host:port,..>  Also dispatch whole-project builds to these workers" << std::endl;
+        std::cout << "  --path-map=<local=remote> Where workers see the source tree (comma-separated)" << std::endl << std::endl;
+
+        std::cout << colorize("EXAMPLES:", Color::BOLD) << std::endl;
+        std::cout << "  focal-run --scan                    # List all projects" << std::endl;
+        std::cout << "  focal-run --MyProject --release     # Build specific project" << std::endl;
+        std::cout << "  focal-run --all --debug             # Build all in debug" << std::endl;
+        std::cout << "  focal-run --test.cpp --build        # Compile single file" << std::endl;
+        std::cout << "  focal-run --rust --all --test       # Test all Rust projects" << std::endl;
+        std::cout << "  focal-run --clean --all             # Clean everything" << std::endl;
+        std::cout << "  focal-run --changed-since=origin/main  # Build what a branch touched" << std::endl;
+        std::cout << "  focal-run --shard=2/4 --shard-timings=last.report  # One of four CI agents" << std::endl;
+        std::cout << "  focal-run --all --workers=box2:7420 --path-map=/src=/mnt/src  # Spread over hosts" << std::endl;
+        std::cout << "  focal-run --all --bench             # Benchmark against last run" << std::endl << std::endl;
+
+        std::cout << colorize("NOTES:", Color::BOLD) << std::endl;
+        std::cout << "  - Auto-detects: CMake, Make, Ninja, MinGW, Visual Studio, Cargo" << std::endl;
+        std::cout << "  - Parallel building with thread pool" << std::endl;
+        std::cout << "  - Configuration caching for speed" << std::endl;
+        std::cout << "  - Specify generator: # Focal-Generator: Ninja" << std::endl;
+        std::cout << "  - Declare dependencies: # Focal-Depends: libcore, ../shared" << std::endl;
+        std::cout << "  - Declare outputs: # Focal-Outputs: build/bin, build/lib" << std::endl;
+        std::cout << "  - Cache file: .focal-run-cache" << std::endl;
+        std::cout << "  - Benchmark history: .focal-run-bench-history" << std::endl;
+        std::cout << "  - Artifact history: .focal-run-artifact-history" << std::endl << std::endl;
+
+        std::cout << colorize(std::string(70, '='), Color::BOLD) << "\n" << std::endl;
+    }
+
+    void parseArguments(const std::vector<std::string>& args) {
+        if (const char* token = getenv("FOCAL_RUN_WORKER_TOKEN")) workerToken = token;
+        for (const std::string& arg : args) {
+            
+            if (arg == "--all") allMode = true;
+            else if (arg == "--rebuild") rebuildMode = true;
+            else if (arg == "--clean") cleanMode = true;
+            else if (arg == "--build") {
+                buildMode = true;
+                cleanMode = false;
+                allMode = true;
+            }
+            else if (arg == "--check") checkMode = true;
+            else if (arg == "--debug") buildType = "Debug";
+            else if (arg == "--release") buildType = "Release";
+            else if (arg == "--verbose") verboseMode = true;
+            else if (arg == "--no-color") colorOutput = false;
+            else if (arg == "--rust") rustMode = true;
+            else if (arg == "--test") testMode = true;
+            else if (arg == "--no-test-cache") testCacheMode = false;
+            else if (arg == "--doc") cargoCommand = "doc";
+            else if (arg == "--run") cargoCommand = "run";
+            else if (arg == "--cargo-check") cargoCommand = "check";
+            else if (arg == "--bench") benchMode = true;
+            else if (arg == "--artifact-stats") artifactStatsMode = true;
+            else if (arg == "--scan") scanMode = true;
+            else if (arg == "--help" || arg == "-h") helpMode = true;
+            else if (arg.substr(0, 7) == "--path=") {
+                customPath = arg.substr(7);
+            }
+            else if (arg.substr(0, 7) == "--jobs=") {
+                try {
+                    maxConcurrentBuilds = std::max(1, std::stoi(arg.substr(7)));
+                    requestedJobs = maxConcurrentBuilds;
+                    jobsExplicit = true;
+                } catch (...) {
+                    std::cerr << colorize("Invalid --jobs value", Color::RED) << std::endl;
+                }
+            }
+            else if (arg.substr(0, 14) == "--global-jobs=") {
+                try {
+                    globalJobs = std::max(1, std::stoi(arg.substr(14)));
+                } catch (...) {
+                    std::cerr << colorize("Invalid --global-jobs value", Color::RED) << std::endl;
+                }
+            }
+            else if (arg.substr(0, 13) == "--bench-reps=") {
+                try {
+                    benchRepetitions = std::max(2, std::stoi(arg.substr(13)));
+                } catch (...) {
+                    std::cerr << colorize("Invalid --bench-reps value", Color::RED) << std::endl;
+                }
+            }
+            else if (arg.substr(0, 12) == "--bench-cpu=") {
+                try {
+                    benchCpu = std::stoi(arg.substr(12));
+                } catch (...) {
+                    std::cerr << colorize("Invalid --bench-cpu value", Color::RED) << std::endl;
+                }
+            }
+            else if (arg.substr(0, 16) == "--artifact-runs=") {
+                try {
+                    artifactRuns = std::max(1, std::stoi(arg.substr(16)));
+                } catch (...) {
+                    std::cerr << colorize("Invalid --artifact-runs value", Color::RED) << std::endl;
+                }
+            }
+            else if (arg.substr(0, 21) == "--artifact-threshold=") {
+                try {
+                    artifactThreshold = std::stod(arg.substr(21));
+                } catch (...) {
+                    std::cerr << colorize("Invalid --artifact-threshold value", Color::RED) << std::endl;
+                }
+            }
+            else if (arg.substr(0, 18) == "--bench-threshold=") {
+                try {
+                    benchThreshold = std::stod(arg.substr(18));
+                } catch (...) {
+                    std::cerr << colorize("Invalid --bench-threshold value", Color::RED) << std::endl;
+                }
+            }
+            else if (arg == "--self-bench") selfBenchMode = true;
+            else if (arg == "--shared-target") sharedTargetMode = true;
+            else if (arg.substr(0, 16) == "--shared-target=") {
+                sharedTargetMode = true;
+                sharedTargetRoot = arg.substr(16);
+            }
+            else if (arg == "--ninja-graph") ninjaGraphMode = true;
+            else if (arg == "--plan") planMode = true;
+            else if (arg == "--tune") tuneMode = true;
+            else if (arg == "--time-report") {
+#ifdef _WIN32
+                std::cerr << colorize("--time-report needs a POSIX shell, ignored", Color::YELLOW) << std::endl;
+#else
+                timeReportMode = true;
+#endif
+            }
+            else if (arg.substr(0, 10) == "--configs=") {
+                buildConfigs = splitList(arg.substr(10), ',');
+                if (buildConfigs.empty()) {
+                    std::cerr << colorize("Invalid --configs value", Color::RED) << std::endl;
+                }
+            }
+            else if (arg == "--pin-slots" || arg == "--numa") {
+#ifdef __linux__
+                (arg == "--numa" ? numaMode : pinSlotsMode) = true;
+#else
+                std::cerr << colorize(arg + " needs Linux CPU affinity, ignored", Color::YELLOW) << std::endl;
+#endif
+            }
+            else if (arg.substr(0, 11) == "--priority=") {
+                priorityLane = arg.substr(11);
+                if (priorityLane != "interactive" && priorityLane != "background") {
+                    throw FocalRunError("Invalid --priority value (interactive or background)");
+                }
+            }
+            else if (arg == "--no-adaptive") adaptiveMode = false;
+            else if (arg.substr(0, 17) == "--configure-jobs=") {
+                try {
+                    configureJobs = std::max(1, std::stoi(arg.substr(17)));
+                } catch (...) {
+                    std::cerr << colorize("Invalid --configure-jobs value", Color::RED) << std::endl;
+                }
+            }
+            else if (arg == "--sccache") {
+                sharedTargetMode = true;
+                sccacheMode = true;
+            }
+            else if (arg.substr(0, 18) == "--self-bench-dirs=") {
+                try {
+                    selfBenchDirs = std::max(1, std::stoi(arg.substr(18)));
+                } catch (...) {
+                    std::cerr << colorize("Invalid --self-bench-dirs value", Color::RED) << std::endl;
+                }
+            }
+            else if (arg.substr(0, 22) == "--self-bench-projects=") {
+                try {
+                    selfBenchProjects = std::max(1, std::stoi(arg.substr(22)));
+                } catch (...) {
+                    std::cerr << colorize("Invalid --self-bench-projects value", Color::RED) << std::endl;
+                }
+            }
+            else if (arg.substr(0, 16) == "--changed-since=") {
+                changedSince = arg.substr(16);
+                changedMode = true;
+                allMode = true;
+            }
+            else if (arg.substr(0, 16) == "--changed-files=") {
+                for (const auto& file : splitList(arg.substr(16), ',')) changedFiles.push_back(file);
+                changedMode = true;
+                allMode = true;
+            }
+            else if (arg.substr(0, 8) == "--shard=") {
+                size_t slash = arg.find('/', 8);
+                try {
+                    shardIndex = std::stoul(arg.substr(8, slash - 8));
+                    shardCount = std::stoul(arg.substr(slash + 1));
+                } catch (...) {
+                    shardCount = 0;
+                }
+                if (slash == std::string::npos || shardCount == 0 || shardIndex < 1 || shardIndex > shardCount) {
+                    throw FocalRunError("Invalid --shard value, expected i/n with 1 <= i <= n");
+                }
+                allMode = true;
+            }
+            else if (arg.substr(0, 16) == "--shard-timings=") shardTimingsFile = arg.substr(16);
+            else if (arg.substr(0, 9) == "--report=") reportFile = arg.substr(9);
+            else if (arg.substr(0, 16) == "--merge-reports=") mergeReports = splitList(arg.substr(16), ',');
+            else if (arg == "--artifact-cache") artifactCacheMode = true;
+            else if (arg.substr(0, 17) == "--artifact-cache=") {
+                artifactCacheMode = true;
+                artifactCacheDir = arg.substr(17);
+            }
+            else if (arg.substr(0, 13) == "--build-root=") {
+                buildRoot = fs::absolute(arg.substr(13)).lexically_normal().string();
+                while (buildRoot.size() > 1 && buildRoot.back() == '/') buildRoot.pop_back();
+            }
+            else if (arg.substr(0, 5) == "--gc=") {
+                gcBudget = parseSize(arg.substr(5));
+                if (gcBudget == 0) {
+                    throw FocalRunError("Invalid --gc value");
+                }
+            }
+            else if (arg.substr(0, 19) == "--build-root-quota=") {
+                buildRootQuota = parseSize(arg.substr(19));
+                if (buildRootQuota == 0) {
+                    throw FocalRunError("Invalid --build-root-quota value");
+                }
+            }
+            else if (arg.substr(0, 22) == "--artifact-cache-size=") {
+                artifactCacheLimit = parseSize(arg.substr(22));
+                if (artifactCacheLimit == 0) {
+                    throw FocalRunError("Invalid --artifact-cache-size value");
+                }
+            }
+            else if (arg == "--worker") workerMode = true;
+            else if (arg.substr(0, 9) == "--worker=") {
+                workerMode = true;
+                workerPort = arg.substr(9);
+            }
+            else if (arg.substr(0, 14) == "--worker-bind=") workerBind = arg.substr(14);
+            else if (arg.substr(0, 15) == "--worker-token=") workerToken = arg.substr(15);
+            else if (arg.substr(0, 15) == "--worker-slots=") {
+                try {
+                    workerSlots = std::max(1, std::stoi(arg.substr(15)));
+                } catch (...) {
+                    std::cerr << colorize("Invalid --worker-slots value", Color::RED) << std::endl;
+                }
+            }
+            else if (arg.substr(0, 10) == "--workers=") workerAddresses = splitList(arg.substr(10), ',');
+            else if (arg.substr(0, 11) == "--path-map=") {
+                for (const auto& mapping : splitList(arg.substr(11), ',')) {
+                    size_t eq = mapping.find('=');
+                    if (eq == std::string::npos) {
+                        throw FocalRunError("Invalid --path-map entry, expected local=remote: " + mapping);
+                    }
+                    pathMappings.push_back({normalizePath(mapping.substr(0, eq)), mapping.substr(eq + 1)});
+                }
+            }
+            else if (arg == "--single-project") singleProjectMode = true;
+            else if (arg.substr(0, 16) == "--bench-pattern=") benchPattern = arg.substr(16);
+            else if (arg.substr(0, 14) == "--bench-label=") benchLabel = arg.substr(14);
+            else if (arg.substr(0, 12) == "--bench-tag=") benchTag = arg.substr(12);
+            else if (arg.substr(0, 17) == "--bench-baseline=") benchBaseline = arg.substr(17);
+            else if (arg.substr(0, 2) == "--") {
+                std::string potentialFile = arg.substr(2);
+                if (potentialFile.find(".cpp") != std::string::npos) {
+                    singleFile = potentialFile;
+                    buildMode = true;
+                } else {
+                    targetProject = potentialFile;
+                }
+            }
+        }
+    }
+
+    static std::string normalizePath(const std::string& path) {
+        std::error_code ec;
+        fs::path normalized = fs::weakly_canonical(fs::absolute(path), ec);
+        if (ec) normalized = fs::absolute(path).lexically_normal();
+        std::string result = normalized.string();
+        while (result.size() > 1 && (result.back() == '/' || result.back() == '\\')) result.pop_back();
+        return result;
+    }
+
+    // Expand a workspace member entry such as "crates/*" to crate directories
+    std::vector<std::string> expandWorkspaceMember(const std::string& root, const std::string& member) {
+        std::vector<fs::path> candidates = {fs::path(root)};
+        for (const auto& part : fs::path(member)) {
+            std::string component = part.string();
+            std::vector<fs::path> next;
+            for (const auto& base : candidates) {
+                if (component.find_first_of("*?") == std::string::npos) {
+                    next.push_back(base / component);
+                    continue;
+                }
+                std::error_code ec;
+                for (const auto& entry : fs::directory_iterator(base, ec)) {
+                    if (entry.is_directory() && matchesPattern(entry.path().filename().string(), component)) {
+                        next.push_back(entry.path());
+                    }
+                }
+            }
+            candidates = next;
+        }
+
+        std::vector<std::string> members;
+        for (const auto& candidate : candidates) {
+            if (fs::exists(candidate / "Cargo.toml")) {
+                members.push_back(normalizePath(candidate.string()));
+            }
+        }
+        return members;
+    }
+
+    // Read [package] name and [workspace] members/exclude from a Cargo.toml
+    void parseCargoManifest(ProjectInfo& proj) {
+        std::ifstream manifest(proj.path + "/Cargo.toml");
+        std::string line, section, listKey, listText;
+        std::vector<std::string> members, excluded;
+
+        auto quotedValues = [](const std::string& text) {
+            std::vector<std::string> values;
+            size_t pos = 0;
+            while ((pos = text.find('"', pos)) != std::string::npos) {
+                size_t end = text.find('"', pos + 1);
+                if (end == std::string::npos) break;
+                values.push_back(text.substr(pos + 1, end - pos - 1));
+                pos = end + 1;
+            }
+            return values;
+        };
+
+        while (std::getline(manifest, line)) {
+            size_t comment = line.find('#');
+            if (comment != std::string::npos && line.find('"') > comment) line.erase(comment);
+            line.erase(0, line.find_first_not_of(" \t"));
+            line.erase(line.find_last_not_of(" \t\r\n") + 1);
+            if (line.empty()) continue;
+
+            // Continuation of a multi-line array
+            if (!listKey.empty()) {
+                listText += " " + line;
+                if (line.find(']') == std::string::npos) continue;
+                (listKey == "members" ? members : excluded) = quotedValues(listText);
+                listKey.clear();
+                continue;
+            }
+
+            if (line[0] == '[') {
+                section = line.substr(0, line.find(']') + 1);
+                continue;
+            }
+
+            size_t eq = line.find('=');
+            if (eq == std::string::npos) continue;
+            std::string key = line.substr(0, eq);
+            key.erase(key.find_last_not_of(" \t") + 1);
+            std::string value = line.substr(eq + 1);
+
+            if (section == "[package]" && key == "name") {
+                auto values = quotedValues(value);
+                if (!values.empty()) proj.packageName = values[0];
+            } else if (section == "[workspace]" && (key == "members" || key == "exclude")) {
+                if (value.find(']') == std::string::npos) {
+                    listKey = key;
+                    listText = value;
+                    continue;
+                }
+                (key == "members" ? members : excluded) = quotedValues(value);
+            }
+        }
+
+        std::unordered_set<std::string> excludedPaths;
+        for (const auto& entry : excluded) {
+            for (const auto& path : expandWorkspaceMember(proj.path, entry)) excludedPaths.insert(path);
+        }
+        proj.workspaceMembers.clear();
+        for (const auto& entry : members) {
+            for (const auto& path : expandWorkspaceMember(proj.path, entry)) {
+                if (!excludedPaths.count(path)) proj.workspaceMembers.push_back(path);
+            }
+        }
+    }
+
+    // Attach member crates to the workspace root that lists them
+    void linkCargoWorkspaces() {
+        std::unordered_map<std::string, ProjectInfo*> byPath;
+        for (auto& proj : projects) {
+            if (proj.buildSystem != BuildSystem::Rust) continue;
+            parseCargoManifest(proj);
+            byPath[normalizePath(proj.path)] = &proj;
+        }
+
+        for (auto& proj : projects) {
+            for (const auto& memberPath : proj.workspaceMembers) {
+                auto member = byPath.find(memberPath);
+                if (member != byPath.end() && member->second != &proj) {
+                    member->second->workspaceRoot = normalizePath(proj.path);
+                }
+            }
+        }
+    }
+
+    void scanProjects(const std::string& startPath = ".") {
+        std::string actualPath = (startPath == ".") ? customPath : startPath;
+        try {
+            std::string currentCMake = actualPath + "/CMakeLists.txt";
+            std::string currentMakefile = actualPath + "/Makefile";
+            std::string currentCargo = actualPath + "/Cargo.toml";
+
+            if (fs::exists(currentCMake)) {
+                std::string projectName = fs::absolute(actualPath).filename().string();
+                if (projectName.empty() || projectName == ".") {
+                    projectName = "RootProject";
+                }
+
+                ProjectInfo proj;
+                proj.name = projectName;
+                proj.path = fs::absolute(actualPath).string();
+                proj.buildType = buildType;
+                proj.buildSystem = BuildSystem::CMake;
+                proj.isMakefileProject = false;
+                projects.push_back(proj);
+            } 
+            else if (fs::exists(currentMakefile)) {
+                std::string projectName = fs::absolute(actualPath).filename().string();
+                if (projectName.empty() || projectName == ".") {
+                    projectName = "RootProject";
+                }
+
+                ProjectInfo proj;
+                proj.name = projectName;
+                proj.path = fs::absolute(actualPath).string();
+                proj.buildType = buildType;
+                proj.buildSystem = BuildSystem::Make;
+                proj.isMakefileProject = true;
+                proj.detectedGenerator = "Make";
+                projects.push_back(proj);
+            } 
+            else if (fs::exists(currentCargo)) {
+                std::string projectName = fs::absolute(actualPath).filename().string();
+                if (projectName.empty() || projectName == ".") {
+                    projectName = "RootProject";
+                }
+
+                ProjectInfo proj;
+                proj.name = projectName;
+                proj.path = fs::absolute(actualPath).string();
+                proj.buildType = buildType;
+                proj.buildSystem = BuildSystem::Rust;
+                proj.isMakefileProject = false;
+                proj.detectedGenerator = "Cargo";
+                projects.push_back(proj);
+            }
+
+            // Scan subdirectories
+            std::string absoluteRoot = fs::absolute(actualPath).string();
+            for (auto it = fs::recursive_directory_iterator(actualPath);
+                 it != fs::recursive_directory_iterator(); ++it) {
+                const auto& entry = *it;
+
+                // Don't descend into build trees, cargo target dirs or VCS metadata
+                if (entry.is_directory()) {
+                    if (entry.path().filename() == ".git" ||
+                        fs::exists(entry.path() / "CMakeCache.txt") ||
+                        fs::exists(entry.path() / "CACHEDIR.TAG")) {
+                        it.disable_recursion_pending();
+                    }
+                    continue;
+                }
+
+                if (entry.is_regular_file()) {
+                    std::string filename = entry.path().filename().string();
+                    std::string projectDir = entry.path().parent_path().string();
+
+                    // Skip if already added
+                    if (fs::absolute(projectDir).string() == absoluteRoot) {
+                        continue;
+                    }
+
+                    if (filename == "CMakeLists.txt") {
+                        std::string projectName = fs::path(projectDir).filename().string();
+                        ProjectInfo proj;
+                        proj.name = projectName;
+                        proj.path = projectDir;
+                        proj.buildType = buildType;
+                        proj.buildSystem = BuildSystem::CMake;
+                        proj.isMakefileProject = false;
+                        projects.push_back(proj);
+                    } 
+                    else if (filename == "Makefile") {
+                        std::string cmakePath = projectDir + "/CMakeLists.txt";
+                        if (fs::exists(cmakePath)) continue;
+
+                        std::string projectName = fs::path(projectDir).filename().string();
+                        ProjectInfo proj;
+                        proj.name = projectName;
+                        proj.path = projectDir;
+                        proj.buildType = buildType;
+                        proj.buildSystem = BuildSystem::Make;
+                        proj.isMakefileProject = true;
+                        proj.detectedGenerator = "Make";
+                        projects.push_back(proj);
+                    } 
+                    else if (filename == "Cargo.toml") {
+                        std::string projectName = fs::path(projectDir).filename().string();
+                        ProjectInfo proj;
+                        proj.name = projectName;
+                        proj.path = projectDir;
+                        proj.buildType = buildType;
+                        proj.buildSystem = BuildSystem::Rust;
+                        proj.isMakefileProject = false;
+                        proj.detectedGenerator = "Cargo";
+                        projects.push_back(proj);
+                    }
+                }
+            }
+
+            // Sort by depth (root first)
+            std::sort(projects.begin(), projects.end(), [](const ProjectInfo& a, const ProjectInfo& b) {
+                int depthA = std::count(a.path.begin(), a.path.end(), fs::path::preferred_separator);
+                int depthB = std::count(b.path.begin(), b.path.end(), fs::path::preferred_separator);
+                return depthA < depthB;
+            });
+
+            linkCargoWorkspaces();
+        } catch (const std::exception& e) {
+            std::cerr << colorize("Error scanning projects: ", Color::RED) << e.what() << std::endl;
+        }
+    }
+
+    void deduplicateProjects() {
+        std::sort(projects.begin(), projects.end(), [](const ProjectInfo& a, const ProjectInfo& b) {
+            return a.path < b.path;
+        });
+        projects.erase(std::unique(projects.begin(), projects.end(), [](const ProjectInfo& a, const ProjectInfo& b) {
+            return a.path == b.path;
+        }), projects.end());
+    }
+
+    void filterProjects() {
+        if (!allMode && !targetProject.empty()) {
+            auto it = std::find_if(projects.begin(), projects.end(),
+                [this](const ProjectInfo& p) { return p.name == targetProject; });
+
+            if (it != projects.end()) {
+                ProjectInfo proj = *it;
+                projects.clear();
+                projects.push_back(proj);
+            } else {
+                throw FocalRunError("Project '" + targetProject + "' not found!");
+            }
+        }
+
+        if (rustMode) {
+            projects.erase(std::remove_if(projects.begin(), projects.end(),
+                [](const ProjectInfo& p) { return p.buildSystem != BuildSystem::Rust; }), 
+                projects.end());
+        }
+
+        if (singleProjectMode) {
+            std::string root = normalizePath(customPath);
+            projects.erase(std::remove_if(projects.begin(), projects.end(),
+                [&](const ProjectInfo& p) { return normalizePath(p.path) != root; }),
+                projects.end());
+        }
+
+        if (changedMode) {
+            filterChangedProjects();
+        }
+
+        if (shardCount > 0) {
+            applyShard();
+        }
+
+        expandConfigurations();
+    }
+
+    // Project -> projects it depends on (normalized paths). Edges come from
+    // "# Focal-Depends: a, b" markers in the project file (names or relative
+    // paths), CMake add_subdirectory() of another project, and Cargo path
+    // dependencies.
+    void analyzeDependencies() {
+        dependencyGraph.clear();
+
+        std::unordered_map<std::string, std::string> byName;
+        std::unordered_set<std::string> roots;
+        for (const auto& proj : projects) {
+            std::string root = normalizePath(proj.path);
+            roots.insert(root);
+            byName.emplace(proj.name, root);
+            if (!proj.packageName.empty()) byName.emplace(proj.packageName, root);
+        }
+
+        auto resolve = [&](const std::string& base, std::string ref, bool allowName) -> std::string {
+            ref.erase(std::remove(ref.begin(), ref.end(), '"'), ref.end());
+            const std::string sourceDir = "${CMAKE_CURRENT_SOURCE_DIR}/";
+            if (ref.rfind(sourceDir, 0) == 0) ref = ref.substr(sourceDir.size());
+            if (ref.empty()) return "";
+
+            std::string candidate = normalizePath((fs::path(base) / ref).string());
+            if (roots.count(candidate)) return candidate;
+            auto named = allowName ? byName.find(ref) : byName.end();
+            return named != byName.end() ? named->second : "";
+        };
+
+        for (const auto& proj : projects) {
+            std::string self = normalizePath(proj.path);
+            auto& deps = dependencyGraph[self];
+
+            for (const char* manifestName : {"CMakeLists.txt", "Makefile", "Cargo.toml"}) {
+                std::ifstream manifest(proj.path + "/" + manifestName);
+                std::string line;
+                while (std::getline(manifest, line)) {
+                    size_t marker = line.find("Focal-Depends:");
+                    if (marker != std::string::npos) {
+                        for (const auto& ref : splitList(line.substr(marker + 14), ',')) {
+                            std::string dep = resolve(proj.path, ref, true);
+                            if (!dep.empty()) deps.insert(dep);
+                        }
+                        continue;
+                    }
+
+                    if (std::string(manifestName) == "CMakeLists.txt") {
+                        std::string lower = line;
+                        std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+                        size_t call = lower.find("add_subdirectory(");
+                        if (call == std::string::npos || lower.find('#') < call) continue;
+                        std::string args = line.substr(call + 17, line.find(')', call) - call - 17);
+                        auto words = splitList(args, ' ');
+                        if (!words.empty()) {
+                            std::string dep = resolve(proj.path, words[0], false);
+                            if (!dep.empty()) deps.insert(dep);
+                        }
+                    } else if (std::string(manifestName) == "Cargo.toml") {
+                        size_t key = line.find("path");
+                        if (key == std::string::npos || line.find('#') < key) continue;
+                        size_t eq = line.find('=', key);
+                        size_t open = line.find('"', eq);
+                        size_t close = open == std::string::npos ? open : line.find('"', open + 1);
+                        if (eq == std::string::npos || close == std::string::npos) continue;
+                        std::string dep = resolve(proj.path, line.substr(open + 1, close - open - 1), false);
+                        if (!dep.empty()) deps.insert(dep);
+                    }
+                }
+            }
+            deps.erase(self);
+        }
+    }
+
+    // Changed files relative to a git ref: committed, staged, unstaged and untracked
+    std::vector<std::string> gitChangedFiles(const std::string& ref) {
+        std::string gitDir = "git -C \"" + escapeShellArg(customPath) + "\" ";
+        std::string top = captureCommand(gitDir + "rev-parse --show-toplevel" + QUIET_STDERR);
+        top.erase(top.find_last_not_of(" \t\r\n") + 1);
+        if (top.empty()) {
+            throw FocalRunError("--changed-since needs a git repository: " + customPath);
+        }
+
+        std::string commit = captureCommand(gitDir + "rev-parse --verify --quiet \"" +
+                                            escapeShellArg(ref) + "^{commit}\"" + QUIET_STDERR);
+        if (commit.find_first_not_of(" \t\r\n") == std::string::npos) {
+            throw FocalRunError("Unknown git ref: " + ref);
+        }
+
+        std::string gitTop = "git -C \"" + escapeShellArg(top) + "\" ";
+        std::string listing = captureCommand(gitTop + "diff --name-only \"" + escapeShellArg(ref) + "\"" + QUIET_STDERR) +
+                              captureCommand(gitTop + "ls-files --others --exclude-standard" + QUIET_STDERR);
+
+        std::vector<std::string> files;
+        for (const auto& file : splitList(listing, '\n')) {
+            files.push_back(normalizePath((fs::path(top) / file).string()));
+        }
+        return files;
+    }
+
+    // Keep the deepest project owning each changed file, plus everything that depends on those
+    void filterChangedProjects() {
+        std::vector<std::string> files;
+        for (const auto& file : changedFiles) files.push_back(normalizePath(file));
+        if (!changedSince.empty()) {
+            std::vector<std::string> fromGit = gitChangedFiles(changedSince);
+            files.insert(files.end(), fromGit.begin(), fromGit.end());
+        }
+
+        analyzeDependencies();
+
+        std::unordered_set<std::string> selected;
+        for (const auto& file : files) {
+            std::string owner;
+            for (const auto& proj : projects) {
+                std::string root = normalizePath(proj.path);
+                bool inside = file == root || file.rfind(root + PATH_SEPARATOR, 0) == 0;
+                if (inside && root.size() > owner.size()) owner = root;
+            }
+            if (!owner.empty()) {
+                selected.insert(owner);
+                if (verboseMode) {
+                    std::cout << colorize("  [CHANGED]", Color::CYAN) << " " << file << std::endl;
+                }
+            }
+        }
+        size_t directCount = selected.size();
+
+        std::unordered_map<std::string, std::vector<std::string>> dependents;
+        for (const auto& entry : dependencyGraph) {
+            for (const auto& dep : entry.second) dependents[dep].push_back(entry.first);
+        }
+        std::vector<std::string> queue(selected.begin(), selected.end());
+        while (!queue.empty()) {
+            std::string current = queue.back();
+            queue.pop_back();
+            for (const auto& dependent : dependents[current]) {
+                if (selected.insert(dependent).second) queue.push_back(dependent);
+            }
+        }
+
+        size_t scanned = projects.size();
+        projects.erase(std::remove_if(projects.begin(), projects.end(),
+            [&](const ProjectInfo& p) { return !selected.count(normalizePath(p.path)); }),
+            projects.end());
+
+        std::cout << colorize("[CHANGED]", Color::CYAN) << " " << files.size() << " changed files -> "
+                 << projects.size() << " of " << scanned << " projects ("
+                 << directCount << " changed, " << selected.size() - directCount << " dependents)" << std::endl;
+
+        if (projects.empty()) {
+            std::cout << colorize("No projects affected by the changes", Color::GREEN) << std::endl;
+            nothingToBuild = true;
+        }
+    }
+
+    // Build time per project (relative path) from a report file, for sharding
+    std::unordered_map<std::string, long> loadReportTimings(const std::string& file) {
+        std::unordered_map<std::string, long> timings;
+        std::ifstream report(file);
+        if (!report.is_open()) {
+            throw FocalRunError("Cannot read report: " + file);
+        }
+
+        std::string line;
+        while (std::getline(report, line)) {
+            if (line.empty() || line[0] == '#') continue;
+            std::vector<std::string> fields;
+            std::stringstream ss(line);
+            std::string field;
+            while (std::getline(ss, field, '\t')) fields.push_back(field);
+            if (fields.size() >= 4) timings[fields[0]] = std::atol(fields[3].c_str());
+        }
+        return timings;
+    }
+
+    // Keep this agent's share of the projects. Projects linked by dependencies
+    // (or one Cargo workspace) stay in one shard; groups are assigned longest
+    // first to the least loaded shard. Everything is ordered by relative path,
+    // so agents with the same tree and timings agree without coordination.
+    void applyShard() {
+        std::unordered_map<std::string, long> timings;
+        if (!shardTimingsFile.empty()) timings = loadReportTimings(shardTimingsFile);
+
+        std::sort(projects.begin(), projects.end(), [this](const ProjectInfo& a, const ProjectInfo& b) {
+            return relativeProjectPath(a) < relativeProjectPath(b);
+        });
+
+        // Only the shared timings file is used: local cache timings differ per agent.
+        // Without it (or for new projects) every project weighs the same
+        std::vector<long> weights;
+        for (const auto& proj : projects) {
+            auto timed = timings.find(relativeProjectPath(proj));
+            weights.push_back(timed != timings.end() ? std::max(1L, timed->second) : 1L);
+        }
+
+        // Union-find over dependency and workspace links
+        std::vector<size_t> parent(projects.size());
+        for (size_t i = 0; i < parent.size(); ++i) parent[i] = i;
+        std::function<size_t(size_t)> find = [&](size_t i) {
+            return parent[i] == i ? i : parent[i] = find(parent[i]);
+        };
+
+        analyzeDependencies();
+        std::unordered_map<std::string, size_t> indexOfPath;
+        for (size_t i = 0; i < projects.size(); ++i) indexOfPath[normalizePath(projects[i].path)] = i;
+        for (size_t i = 0; i < projects.size(); ++i) {
+            std::vector<std::string> links(dependencyGraph[normalizePath(projects[i].path)].begin(),
+                                           dependencyGraph[normalizePath(projects[i].path)].end());
+            if (!projects[i].workspaceRoot.empty()) links.push_back(projects[i].workspaceRoot);
+            for (const auto& link : links) {
+                auto other = indexOfPath.find(link);
+                if (other != indexOfPath.end()) parent[find(i)] = find(other->second);
+            }
+        }
+
+        std::map<size_t, std::pair<long, std::vector<size_t>>> groups;
+        for (size_t i = 0; i < projects.size(); ++i) {
+            auto& group = groups[find(i)];
+            group.first += weights[i];
+            group.second.push_back(i);
+        }
+
+        std::vector<std::pair<long, std::vector<size_t>>> ordered;
+        for (auto& entry : groups) ordered.push_back(entry.second);
+        std::stable_sort(ordered.begin(), ordered.end(), [](const auto& a, const auto& b) {
+            if (a.first != b.first) return a.first > b.first;
+            return a.second.front() < b.second.front();
+        });
+
+        std::vector<long> load(shardCount, 0);
+        std::vector<bool> keep(projects.size(), false);
+        long total = 0;
+        for (const auto& group : ordered) {
+            size_t target = std::min_element(load.begin(), load.end()) - load.begin();
+            load[target] += group.first;
+            total += group.first;
+            if (target == shardIndex - 1) {
+                for (size_t i : group.second) keep[i] = true;
+            }
+        }
+
+        std::vector<ProjectInfo> selected;
+        for (size_t i = 0; i < projects.size(); ++i) {
+            if (keep[i]) selected.push_back(projects[i]);
+        }
+        size_t scanned = projects.size();
+        projects = selected;
+        linkCargoWorkspaces();
+
+        std::cout << colorize("[SHARD]", Color::CYAN) << " " << shardIndex << "/" << shardCount << ": "
+                 << projects.size() << " of " << scanned << " projects, ~"
+                 << load[shardIndex - 1] << "ms of ~" << total << "ms"
+                 << (timings.empty() ? " (no --shard-timings, balanced by count)" : " recorded") << std::endl;
+
+        if (reportFile.empty()) {
+            reportFile = ".focal-run-report-" + std::to_string(shardIndex) + "of" + std::to_string(shardCount);
+        }
+
+        if (projects.empty()) {
+            writeReport();
+            std::cout << colorize("No projects in this shard", Color::GREEN) << std::endl;
+            nothingToBuild = true;
+        }
+    }
+
+    // Tab-separated result per project: relative path, name, status, ms, generator
+    void writeReport() {
+        std::ofstream report(reportFile);
+        if (!report.is_open()) {
+            std::cerr << colorize("[ERROR]", Color::RED) << " Cannot write report: " << reportFile << std::endl;
+            return;
+        }
+
+        report << "# focal-run report";
+        if (shardCount > 0) report << " shard=" << shardIndex << "/" << shardCount;
+        report << std::endl;
+        for (const auto& proj : projects) {
+            report << relativeProjectPath(proj) << "\t" << proj.name << "\t"
+                   << (proj.success ? "ok" : "failed") << "\t" << proj.stats.totalTime.count() << "\t"
+                   << proj.detectedGenerator << std::endl;
+        }
+
+        if (verboseMode) {
+            std::cout << colorize("[REPORT]", Color::CYAN) << " Wrote " << reportFile << std::endl;
+        }
+    }
+
+    // Print one build report from several shard reports; false when a shard is
+    // missing or a project failed
+    bool mergeReportFiles() {
+        projects.clear();
+        std::unordered_set<std::string> seenShards;
+        size_t expectedShards = 0;
+
+        for (const auto& file : mergeReports) {
+            std::ifstream report(file);
+            if (!report.is_open()) {
+                throw FocalRunError("Cannot read report: " + file);
+            }
+
+            std::string line;
+            while (std::getline(report, line)) {
+                if (line.empty()) continue;
+                if (line[0] == '#') {
+                    size_t shard = line.find("shard=");
+                    if (shard != std::string::npos) {
+                        std::string spec = line.substr(shard + 6);
+                        seenShards.insert(spec.substr(0, spec.find('/')));
+                        expectedShards = std::max(expectedShards, (size_t)std::atol(spec.c_str() + spec.find('/') + 1));
+                    }
+                    continue;
+                }
+
+                std::vector<std::string> fields;
+                std::stringstream ss(line);
+                std::string field;
+                while (std::getline(ss, field, '\t')) fields.push_back(field);
+                if (fields.size() < 5) continue;
+
+                ProjectInfo proj;
+                proj.path = fields[0];
+                proj.name = fields[1];
+                proj.success = fields[2] == "ok";
+                proj.stats.totalTime = std::chrono::milliseconds(std::atol(fields[3].c_str()));
+                proj.detectedGenerator = fields[4];
+                projects.push_back(proj);
+            }
+        }
+
+        std::sort(projects.begin(), projects.end(), [](const ProjectInfo& a, const ProjectInfo& b) {
+            return a.path < b.path;
+        });
+
+        if (seenShards.size() < expectedShards) {
+            std::cerr << colorize("[WARN]", Color::YELLOW) << " Only " << seenShards.size() << " of "
+                     << expectedShards << " shard reports given" << std::endl;
+        }
+
+        printReport();
+
+        // The merged report doubles as --shard-timings input for the next run
+        if (!reportFile.empty()) {
+            customPath = ".";
+            writeReport();
+        }
+
+        return seenShards.size() >= expectedShards &&
+               std::none_of(projects.begin(), projects.end(), [](const ProjectInfo& p) { return !p.success; });
+    }
+
+    // "# Focal-Outputs: a, b" in the project file, or nothing
+    std::vector<std::string> manifestOutputs(const ProjectInfo& proj) {
+        for (const char* manifestName : {"CMakeLists.txt", "Makefile", "Cargo.toml"}) {
+            std::ifstream manifest(proj.path + "/" + manifestName);
+            std::string line;
+            while (std::getline(manifest, line)) {
+                size_t marker = line.find("Focal-Outputs:");
+                if (marker != std::string::npos) return splitList(line.substr(marker + 14), ',');
+            }
+        }
+        return {};
+    }
+
+    // Output directories stored in the artifact cache: "# Focal-Outputs: a, b"
+    // in the project file, otherwise the directories focal-run builds into.
+    // Makefile projects often keep sources in bin/ or lib/, so those are only
+    // outputs when declared
+    std::vector<std::string> declaredOutputs(const ProjectInfo& proj) {
+        std::vector<std::string> declared = manifestOutputs(proj);
+        if (!declared.empty()) return declared;
+
+        if (proj.buildSystem == BuildSystem::Rust) return {"target"};
+        if (proj.isMakefileProject) return {"build", "release", "debug"};
+        if (!proj.config.empty()) return {"build/" + proj.config};
+        return {"build"};
+    }
+
+    // Hash of every source file below a project, skipping outputs, build trees and VCS data
+    std::string contentFingerprint(const std::string& root, const std::vector<std::string>& outputs) {
+        std::vector<std::pair<std::string, std::string>> files;
+        forEachSourceFile(root, outputs, [&](const fs::directory_entry& entry) {
+            files.push_back({fs::relative(entry.path(), root).generic_string(), hashFile(entry.path().string())});
+        });
+
+        std::sort(files.begin(), files.end());
+        std::string listing;
+        for (const auto& file : files) listing += file.first + " " + file.second + "\n";
+        return hashString(listing);
+    }
+
+    // Cheap up-to-date check for --plan: size and mtime of every source file,
+    // plus the toolchain and the configuration the project is built with
+    std::string inputSignature(const ProjectInfo& proj) {
+        std::vector<std::string> files;
+        forEachSourceFile(proj.path, declaredOutputs(proj), [&](const fs::directory_entry& entry) {
+            std::error_code ec;
+            auto mtime = entry.last_write_time(ec).time_since_epoch().count();
+            files.push_back(fs::relative(entry.path(), proj.path, ec).generic_string() + " " +
+                            std::to_string(entry.file_size(ec)) + " " + std::to_string(mtime));
+        });
+
+        std::sort(files.begin(), files.end());
+        std::string listing = toolchainSignature(proj) + "\n" + proj.buildType + "\n" + cargoCommand + "\n";
+        for (const auto& file : files) listing += file + "\n";
+        return hashString(listing);
+    }
+
+    // What a dependent sees of a project, for early cutoff: its headers plus its
+    // build artifacts. Declared outputs are hashed whole; default build trees only
+    // by libraries and executables, since logs, depfiles and stamps change on
+    // every build. A header edit that leaves the library identical still counts
+    std::string outputHash(const ProjectInfo& proj) {
+        std::vector<std::pair<std::string, std::string>> files;
+        forEachSourceFile(proj.path, declaredOutputs(proj), [&](const fs::directory_entry& entry) {
+            static const std::set<std::string> headers = {".h", ".hh", ".hpp", ".hxx", ".inc", ".inl", ".ipp", ".tcc"};
+            if (!headers.count(entry.path().extension().string())) return;
+            files.push_back({"src/" + fs::relative(entry.path(), proj.path).generic_string(), hashFile(entry.path().string())});
+        });
+
+        std::vector<std::string> roots = outputRoots(proj);
+        bool declared = !manifestOutputs(proj).empty();
+        for (size_t i = 0; i < roots.size(); ++i) {
+            forEachOutputFile(roots[i], !declared, [&](const fs::directory_entry& entry) {
+                files.push_back({std::to_string(i) + "/" + fs::relative(entry.path(), roots[i]).generic_string(),
+                                 hashFile(entry.path().string())});
+            });
+        }
+
+        std::sort(files.begin(), files.end());
+        std::string listing;
+        for (const auto& file : files) listing += file.first + " " + file.second + "\n";
+        return hashString(listing);
+    }
+
+    // Where a build leaves its outputs: the manifest's declared outputs, the
+    // cargo profile directory, the Makefile output dirs or the CMake build tree
+    std::vector<std::string> outputRoots(const ProjectInfo& proj) {
+        std::vector<std::string> roots;
+        if (!manifestOutputs(proj).empty()) {
+            for (const auto& output : manifestOutputs(proj)) roots.push_back(proj.path + "/" + output);
+        } else if (proj.buildSystem == BuildSystem::Rust) {
+            std::string target = proj.cargoTargetDir.empty() ? proj.path + "/target" : proj.cargoTargetDir;
+            roots.push_back(target + (cargoProfileFlag(proj).empty() ? "/debug" : "/release"));
+        } else if (proj.isMakefileProject) {
+            std::string base = buildRoot.empty() ? proj.path : buildRootDir(proj);
+            for (const auto& output : declaredOutputs(proj)) roots.push_back(base + "/" + output);
+        } else {
+            roots.push_back(cmakeBuildDir(proj));
+        }
+        return roots;
+    }
+
+    // Files below an output root, past CMake and cargo bookkeeping. With
+    // artifactsOnly, just libraries and executables
+    void forEachOutputFile(const std::string& root, bool artifactsOnly,
+                           const std::function<void(const fs::directory_entry&)>& onFile) {
+        static const std::set<std::string> skippedDirs = {"CMakeFiles", "Testing", "deps", "build", ".fingerprint", "incremental"};
+        static const std::set<std::string> artifacts = {".a", ".so", ".dylib", ".dll", ".lib", ".exe", ".rlib", ".jar", ".wasm"};
+        std::error_code ec;
+        if (!fs::is_directory(root, ec)) return;
+        for (auto it = fs::recursive_directory_iterator(root, ec);
+             !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+            const auto& entry = *it;
+            std::string name = entry.path().filename().string();
+            if (entry.is_directory()) {
+                if (skippedDirs.count(name)) it.disable_recursion_pending();
+                continue;
+            }
+            if (!entry.is_regular_file()) continue;
+            if (artifactsOnly) {
+                bool executable = (entry.status().permissions() & fs::perms::owner_exec) != fs::perms::none;
+                if (!executable && !artifacts.count(entry.path().extension().string()) &&
+                    name.find(".so.") == std::string::npos) continue;
+            }
+            onFile(entry);
+        }
+    }
+
+    // Every file below a project, skipping outputs, build trees and VCS data
+    void forEachSourceFile(const std::string& root, const std::vector<std::string>& outputs,
+                           const std::function<void(const fs::directory_entry&)>& onFile) {
+        std::unordered_set<std::string> skipped;
+        for (const auto& output : outputs) skipped.insert(normalizePath(root + "/" + output));
+
+        std::error_code ec;
+        for (auto it = fs::recursive_directory_iterator(root, ec);
+             !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+            const auto& entry = *it;
+            std::string name = entry.path().filename().string();
+            if (entry.is_directory()) {
+                if (name == ".git" || skipped.count(normalizePath(entry.path().string())) ||
+                    fs::exists(entry.path() / "CMakeCache.txt") || fs::exists(entry.path() / "CACHEDIR.TAG")) {
+                    it.disable_recursion_pending();
+                }
+                continue;
+            }
+            if (!entry.is_regular_file() || name.rfind(".focal-run", 0) == 0) continue;
+            onFile(entry);
+        }
+    }
+
+    // Compiler and tool versions plus the environment that changes their output
+    std::string toolchainSignature(const ProjectInfo& proj) {
+        std::string kind = proj.buildSystem == BuildSystem::Rust ? "rust" : (proj.isMakefileProject ? "make" : "cmake");
+        std::lock_guard<std::mutex> lock(toolchainMutex);
+        auto known = toolchainSignatures.find(kind);
+        if (known != toolchainSignatures.end()) return known->second;
+
+        std::string signature;
+        if (kind == "rust") {
+            signature = captureCommand("rustc -vV" QUIET_STDERR) + captureCommand("cargo -V" QUIET_STDERR);
+        } else {
+            signature = captureCommand((kind == "make" ? "make --version" : "cmake --version") + std::string(QUIET_STDERR)) +
+                        captureCommand("c++ --version" QUIET_STDERR) + captureCommand("cc --version" QUIET_STDERR);
+        }
+        for (const char* var : {"CC", "CXX", "CFLAGS", "CXXFLAGS", "LDFLAGS", "RUSTFLAGS"}) {
+            const char* value = getenv(var);
+            signature += std::string(var) + "=" + (value ? value : "") + "\n";
+        }
+        return toolchainSignatures[kind] = hashString(signature);
+    }
+
+    // Store key: project sources, sources of everything it depends on, toolchain, build type
+    std::string computeArtifactKey(const ProjectInfo& proj) {
+        std::string material = toolchainSignature(proj) + "\n" + proj.buildType + "\n" +
+                               proj.detectedGenerator + "\n" + cargoCommand + "\n" +
+                               contentFingerprint(proj.path, declaredOutputs(proj)) + "\n";
+
+        // CMake build trees embed absolute paths, so they only fit the same checkout location
+        if (proj.buildSystem != BuildSystem::Rust && !proj.isMakefileProject) {
+            material += normalizePath(proj.path) + "\n";
+        }
+
+        std::vector<std::string> queue = {normalizePath(proj.path)};
+        std::set<std::string> deps;
+        while (!queue.empty()) {
+            std::string current = queue.back();
+            queue.pop_back();
+            auto edges = dependencyGraph.find(current);
+            if (edges == dependencyGraph.end()) continue;
+            for (const auto& dep : edges->second) {
+                if (deps.insert(dep).second) queue.push_back(dep);
+            }
+        }
+        for (const auto& dep : deps) material += dep + " " + contentFingerprint(dep, {"build", "target"}) + "\n";
+
+        return hashString(material);
+    }
+
+    // Reflink where the filesystem supports it, otherwise a plain copy. Hardlinks
+    // are not used: compilers and linkers rewrite outputs in place, which would
+    // corrupt the stored copy
+    static bool cloneFile(const fs::path& from, const fs::path& to) {
+        std::error_code ec;
+#ifdef __linux__
+        int source = open(from.c_str(), O_RDONLY);
+        if (source >= 0) {
+            int target = open(to.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            bool cloned = target >= 0 && ioctl(target, FICLONE, source) == 0;
+            if (target >= 0) close(target);
+            close(source);
+            if (cloned) {
+                fs::permissions(to, fs::status(from, ec).permissions(), ec);
+                return true;
+            }
+        }
+#endif
+        return fs::copy_file(from, to, fs::copy_options::overwrite_existing, ec);
+    }
+
+    // Copy a tree file by file, keeping symlinks; mtimes are shifted by `shift`
+    static bool copyTree(const fs::path& from, const fs::path& to, fs::file_time_type::duration shift) {
+        std::error_code ec;
+        fs::create_directories(to, ec);
+        for (auto it = fs::recursive_directory_iterator(from, ec);
+             !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+            fs::path target = to / fs::relative(it->path(), from);
+            if (it->is_symlink()) {
+                fs::copy_symlink(it->path(), target, ec);
+            } else if (it->is_directory()) {
+                fs::create_directories(target, ec);
+            } else if (it->is_regular_file()) {
+                if (!cloneFile(it->path(), target)) return false;
+                fs::last_write_time(target, fs::last_write_time(it->path(), ec) + shift, ec);
+            }
+            if (ec) return false;
+        }
+        return !ec;
+    }
+
+    std::string artifactStoreDir() {
+        return artifactCacheDir.empty() ? userCacheDir() + "/artifacts" : artifactCacheDir;
+    }
+
+    bool artifactCacheApplies(const ProjectInfo& proj) {
+        return artifactCacheMode && !cleanMode && !timeReportMode && buildRoot.empty() && (cargoCommand == "build" || proj.buildSystem != BuildSystem::Rust) &&
+               proj.cargoTargetDir.empty() && ninjaGraphPrefixes.find(proj.path) == ninjaGraphPrefixes.end() &&
+               !(multiConfigGenerator && !proj.config.empty() && proj.buildSystem != BuildSystem::Rust);
+    }
+
+    // Replace the project's outputs with a stored copy for the same key
+    bool restoreArtifacts(ProjectInfo& proj) {
+        if (!artifactCacheApplies(proj)) return false;
+        proj.artifactKey = computeArtifactKey(proj);
+        // File times lag the clock by up to a timer tick
+        proj.artifactSince = fs::file_time_type::clock::now() - std::chrono::milliseconds(50);
+        if (rebuildMode) return false;
+
+        fs::path entry = fs::path(artifactStoreDir()) / proj.artifactKey;
+        std::error_code ec;
+        if (!fs::exists(entry / "meta", ec)) return false;
+
+        // Newest stored file lands at "now", keeping the relative order make/ninja rely on
+        fs::file_time_type newest = fs::file_time_type::min();
+        for (auto it = fs::recursive_directory_iterator(entry / "files", ec);
+             !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+            if (it->is_regular_file()) newest = std::max(newest, fs::last_write_time(it->path(), ec));
+        }
+        // An entry without a single file would skip the build and leave nothing behind
+        if (newest == fs::file_time_type::min()) return false;
+        auto shift = fs::file_time_type::clock::now() - newest;
+
+        // Only directories the project declares as outputs are replaced; an entry
+        // holding anything else (stored under an older output list) is a miss
+        std::map<std::string, fs::path> targets;
+        for (const auto& output : declaredOutputs(proj)) {
+            targets[fs::path(output).filename().string()] = fs::path(proj.path) / output;
+        }
+        for (const auto& output : fs::directory_iterator(entry / "files", ec)) {
+            if (!targets.count(output.path().filename().string())) return false;
+        }
+
+        for (const auto& output : fs::directory_iterator(entry / "files", ec)) {
+            fs::path target = targets[output.path().filename().string()];
+            fs::remove_all(target, ec);
+            if (!copyTree(output.path(), target, shift)) {
+                fs::remove_all(target, ec);
+                return false;
+            }
+        }
+
+        fs::last_write_time(entry / "meta", fs::file_time_type::clock::now(), ec);
+        proj.restoredFromCache = true;
+        std::lock_guard<std::mutex> lock(outputMutex);
+        std::cout << colorize("  [ARTIFACT]", Color::GREEN) << " Restored " << proj.name
+                 << " from " << proj.artifactKey << std::endl;
+        return true;
+    }
+
+    // Copy the outputs of a successful build into the store under its key. Only
+    // outputs holding files count; of the default Makefile dirs, which focal-run
+    // creates itself, only those the build wrote into since it started
+    void storeArtifacts(const ProjectInfo& proj) {
+        if (proj.artifactKey.empty() || proj.restoredFromCache) return;
+
+        fs::path store = artifactStoreDir();
+        fs::path entry = store / proj.artifactKey;
+        fs::path staging = store / (proj.artifactKey + ".tmp-" + hashString(normalizePath(proj.path)));
+        std::error_code ec;
+        if (fs::exists(entry / "meta", ec)) return;
+        fs::remove_all(staging, ec);
+
+        bool changedOnly = proj.isMakefileProject && manifestOutputs(proj).empty();
+        unsigned long long size = 0;
+        for (const auto& output : declaredOutputs(proj)) {
+            fs::path source = fs::path(proj.path) / output;
+            unsigned long long outputSize = 0;
+            bool files = false, changed = false;
+            for (auto it = fs::recursive_directory_iterator(source, ec);
+                 !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+                if (!it->is_regular_file() || it->is_symlink()) continue;
+                files = true;
+                outputSize += it->file_size(ec);
+                if (it->last_write_time(ec) >= proj.artifactSince) changed = true;
+            }
+            if (!files || (changedOnly && !changed)) continue;
+            if (!copyTree(source, staging / "files" / fs::path(output).filename(), fs::file_time_type::duration(0))) {
+                fs::remove_all(staging, ec);
+                return;
+            }
+            size += outputSize;
+        }
+        if (!fs::exists(staging / "files", ec)) return;
+
+        std::ofstream(staging / "meta") << "name=" << proj.name << "\npath=" << normalizePath(proj.path)
+                                        << "\nsize=" << size << std::endl;
+        fs::rename(staging, entry, ec);
+        if (ec) fs::remove_all(staging, ec);
+
+        if (verboseMode) {
+            std::lock_guard<std::mutex> lock(outputMutex);
+            std::cout << colorize("  [ARTIFACT]", Color::CYAN) << " Stored " << proj.name << " ("
+                     << size / (1024 * 1024) << " MB)" << std::endl;
+        }
+    }
+
+    // Drop least recently used entries until the store fits its size limit
+    void collectArtifactGarbage() {
+        std::vector<std::tuple<fs::file_time_type, unsigned long long, fs::path>> entries;
+        unsigned long long total = 0;
+        std::error_code ec;
+        for (const auto& entry : fs::directory_iterator(artifactStoreDir(), ec)) {
+            std::ifstream meta(entry.path() / "meta");
+            if (!meta.is_open()) continue;
+            std::string line;
+            unsigned long long size = 0;
+            while (std::getline(meta, line)) {
+                if (line.rfind("size=", 0) == 0) size = std::stoull(line.substr(5));
+            }
+            entries.emplace_back(fs::last_write_time(entry.path() / "meta", ec), size, entry.path());
+            total += size;
+        }
+
+        std::sort(entries.begin(), entries.end());
+        for (const auto& entry : entries) {
+            if (total <= artifactCacheLimit) break;
+            fs::remove_all(std::get<2>(entry), ec);
+            total -= std::get<1>(entry);
+            if (verboseMode) {
+                std::cout << colorize("  [ARTIFACT]", Color::YELLOW) << " Evicted "
+                         << std::get<2>(entry).filename().string() << std::endl;
+            }
+        }
+    }
+
+#ifndef _WIN32
+    // Line-oriented socket I/O for the coordinator/worker protocol
+    static bool sendLine(int fd, const std::string& line) {
+        std::string data = line + "\n";
+        size_t sent = 0;
+        while (sent < data.size()) {
+            ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return false;
+            sent += n;
+        }
+        return true;
+    }
+
+    static bool readLine(int fd, std::string& buffer, std::string& line) {
+        size_t newline;
+        while ((newline = buffer.find('\n')) == std::string::npos) {
+            char chunk[4096];
+            ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return false;
+            buffer.append(chunk, n);
+        }
+        line = buffer.substr(0, newline);
+        buffer.erase(0, newline + 1);
+        return true;
+    }
+
+    static int openSocket(const std::string& host, const std::string& port, bool listening) {
+        struct addrinfo hints {};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        if (listening) hints.ai_flags = AI_PASSIVE;
+
+        struct addrinfo* addresses = nullptr;
+        if (getaddrinfo(host.empty() ? nullptr : host.c_str(), port.c_str(), &hints, &addresses) != 0) return -1;
+
+        int fd = -1;
+        for (struct addrinfo* address = addresses; address; address = address->ai_next) {
+            fd = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+            if (fd < 0) continue;
+            if (listening) {
+                int reuse = 1;
+                setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+                if (bind(fd, address->ai_addr, address->ai_addrlen) == 0 && listen(fd, 16) == 0) break;
+            } else if (connect(fd, address->ai_addr, address->ai_addrlen) == 0) {
+                break;
+            }
+            close(fd);
+            fd = -1;
+        }
+        freeaddrinfo(addresses);
+        return fd;
+    }
+#endif
+
+    // Worker: accept coordinators and run each BUILD request as a child focal-run
+    // restricted to that project, streaming its output back line by line.
+    //   coordinator -> worker:  HELLO <token>
+    //   worker -> coordinator:  HELLO slots=<n> host=<name>
+    //   coordinator -> worker:  BUILD <id>\t<token>\t<path>\t<extra args>
+    //   worker -> coordinator:  LOG <id> <line> ... then DONE <id> <exit code> <ms>,
+    //                           or BUSY <id> when its queue is full
+    // A wrong token closes the connection. Extra args must be options that
+    // workerBuildArgs() emits, and the child is exec'd without a shell
+    void runWorker() {
+#ifdef _WIN32
+        throw FocalRunError("--worker is not supported on Windows");
+#else
+        if (workerToken.empty()) {
+            throw FocalRunError("--worker needs a shared secret: set FOCAL_RUN_WORKER_TOKEN or --worker-token");
+        }
+        int server = openSocket(workerBind, workerPort, true);
+        if (server < 0) {
+            throw FocalRunError("Cannot listen on " + workerBind + ":" + workerPort);
+        }
+        std::cout << colorize("[WORKER]", Color::CYAN) << " Listening on " << workerBind << ":" << workerPort
+                 << " with " << workerSlots << " slots" << std::endl;
+
+        while (true) {
+            int client = accept(server, nullptr, nullptr);
+            if (client < 0) {
+                if (errno == EINTR) continue;
+                break;
+            }
+            std::thread([this, client]() { serveCoordinator(client); }).detach();
+        }
+        close(server);
+#endif
+    }
+
+#ifndef _WIN32
+    // Constant-time comparison, so response timing does not leak the token
+    static bool tokenMatches(const std::string& given, const std::string& expected) {
+        if (given.size() != expected.size()) return false;
+        unsigned char diff = 0;
+        for (size_t i = 0; i < given.size(); ++i) diff |= given[i] ^ expected[i];
+        return diff == 0;
+    }
+
+    // The options workerBuildArgs() emits; a BUILD request with anything else is refused
+    static bool allowedWorkerArg(const std::string& arg) {
+        static const std::set<std::string> flags = {"--debug", "--release", "--verbose", "--rebuild", "--test",
+                                                    "--no-test-cache", "--doc", "--cargo-check",
+                                                    "--priority=interactive", "--priority=background"};
+        if (flags.count(arg)) return true;
+        if (arg.rfind("--configs=", 0) != 0 || arg.size() == 10) return false;
+        return std::all_of(arg.begin() + 10, arg.end(), [](unsigned char c) { return std::isalnum(c) || c == '_'; });
+    }
+
+    // Run the child focal-run for one BUILD request: exec'd directly with an
+    // argument vector, stdout and stderr handed over line by line
+    int runWorkerChild(const std::string& path, const std::vector<std::string>& extraArgs,
+                       const std::function<void(const std::string&)>& onLine) {
+        std::vector<std::string> args = {selfExecutable, "--path=" + path, "--single-project", "--no-color", "--no-adaptive"};
+        args.insert(args.end(), extraArgs.begin(), extraArgs.end());
+        std::vector<char*> argv;
+        for (auto& arg : args) argv.push_back(&arg[0]);
+        argv.push_back(nullptr);
+
+        int output[2];
+        if (!openPipe(output)) return 127;
+        pid_t pid = fork();
+        if (pid < 0) {
+            close(output[0]);
+            close(output[1]);
+            return 127;
+        }
+        if (pid == 0) {
+            dup2(output[1], STDOUT_FILENO);
+            dup2(output[1], STDERR_FILENO);
+            close(output[0]);
+            close(output[1]);
+            if (chdir(path.c_str()) != 0) _exit(127);
+            execvp(argv[0], argv.data());
+            _exit(127);
+        }
+
+        close(output[1]);
+        std::string pending;
+        char chunk[4096];
+        ssize_t n;
+        while ((n = read(output[0], chunk, sizeof(chunk))) != 0) {
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                break;
+            }
+            pending.append(chunk, n);
+            size_t end;
+            while ((end = pending.find('\n')) != std::string::npos) {
+                std::string text = pending.substr(0, end);
+                text.erase(text.find_last_not_of("\r") + 1);
+                onLine(text);
+                pending.erase(0, end + 1);
+            }
+        }
+        if (!pending.empty()) onLine(pending);
+        close(output[0]);
+
+        int status = 0;
+        while (waitpid(pid, &status, 0) < 0) {
+            if (errno != EINTR) return 127;
+        }
+        return WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+    }
+
+    void serveCoordinator(int fd) {
+        std::string buffer, line;
+        if (!readLine(fd, buffer, line) || line.rfind("HELLO ", 0) != 0 || !tokenMatches(line.substr(6), workerToken)) {
+            std::lock_guard<std::mutex> lock(outputMutex);
+            std::cerr << colorize("[WORKER]", Color::YELLOW) << " Rejected a connection with a wrong token" << std::endl;
+            close(fd);
+            return;
+        }
+
+        char hostname[256] = "worker";
+        gethostname(hostname, sizeof(hostname) - 1);
+
+        std::mutex sendMutex;
+        auto reply = [&](const std::string& line) {
+            std::lock_guard<std::mutex> lock(sendMutex);
+            return sendLine(fd, line);
+        };
+        reply("HELLO slots=" + std::to_string(workerSlots) + " host=" + hostname);
+
+        std::vector<std::thread> builds;
+        while (readLine(fd, buffer, line)) {
+            if (line.rfind("BUILD ", 0) != 0) continue;
+            std::vector<std::string> fields;
+            std::stringstream ss(line.substr(6));
+            std::string field;
+            while (std::getline(ss, field, '\t')) fields.push_back(field);
+            if (fields.size() < 3) continue;
+
+            std::string id = fields[0];
+            if (!tokenMatches(fields[1], workerToken)) break;
+
+            std::string path = fields[2];
+            std::vector<std::string> args;
+            std::stringstream argStream(fields.size() > 3 ? fields[3] : "");
+            std::string arg;
+            bool allowed = !path.empty() && path[0] == '/' && fs::is_directory(path);
+            while (argStream >> arg) {
+                allowed = allowed && allowedWorkerArg(arg);
+                args.push_back(arg);
+            }
+            if (!allowed) {
+                reply("LOG " + id + " [WORKER] Refused: not a directory or an option a coordinator does not send");
+                reply("DONE " + id + " 2 0");
+                continue;
+            }
+
+            // Builds past workerSlots wait for a slot; past twice that the coordinator builds locally
+            {
+                std::lock_guard<std::mutex> lock(workerSlotMutex);
+                if (workerActive + workerQueued >= 2 * workerSlots) {
+                    reply("BUSY " + id);
+                    continue;
+                }
+                workerQueued++;
+            }
+            {
+                std::lock_guard<std::mutex> lock(outputMutex);
+                std::cout << colorize("[WORKER]", Color::CYAN) << " Building " << path << std::endl;
+            }
+
+            builds.emplace_back([this, id, path, args, &reply]() {
+                {
+                    std::unique_lock<std::mutex> lock(workerSlotMutex);
+                    workerSlotCv.wait(lock, [this]() { return workerActive < workerSlots; });
+                    workerQueued--;
+                    workerActive++;
+                }
+                auto start = std::chrono::steady_clock::now();
+                int exitCode = runWorkerChild(path, args, [&](const std::string& text) { reply("LOG " + id + " " + text); });
+                auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now() - start).count();
+                {
+                    std::lock_guard<std::mutex> lock(workerSlotMutex);
+                    workerActive--;
+                }
+                workerSlotCv.notify_one();
+                reply("DONE " + id + " " + std::to_string(exitCode) + " " + std::to_string(ms));
+            });
+        }
+
+        for (auto& build : builds) build.join();
+        close(fd);
+    }
+#endif
+
+    // Path of a project as the workers see it
+    std::string mapWorkerPath(const std::string& path) {
+        std::string local = normalizePath(path);
+        for (const auto& mapping : pathMappings) {
+            if (local == mapping.first || local.rfind(mapping.first + "/", 0) == 0) {
+                return mapping.second + local.substr(mapping.first.size());
+            }
+        }
+        return local;
+    }
+
+    // Options a worker's child focal-run needs to build a project the same way
+    std::string workerBuildArgs(const ProjectInfo& proj) {
+        // Always verbose: the coordinator shows the log tail of failed builds
+        std::string args = !proj.config.empty() ? "--configs=" + proj.config
+                                                : std::string(buildType == "Debug" ? "--debug" : "--release");
+        args += " --verbose";
+        if (rebuildMode) args += " --rebuild";
+        if (testMode) args += " --test";
+        if (!testCacheMode) args += " --no-test-cache";
+        if (cargoCommand == "doc") args += " --doc";
+        else if (cargoCommand == "check") args += " --cargo-check";
+        if (!priorityLane.empty()) args += " --priority=" + priorityLane;
+        return args;
+    }
+
+    // Connect to every --workers address; unreachable workers are skipped with a warning
+    std::vector<std::unique_ptr<RemoteWorker>> connectWorkers() {
+        std::vector<std::unique_ptr<RemoteWorker>> remotes;
+#ifdef _WIN32
+        if (!workerAddresses.empty()) {
+            std::cerr << colorize("  [WARN]", Color::YELLOW) << " --workers is not supported on Windows" << std::endl;
+        }
+#else
+        if (timeReportMode && !workerAddresses.empty()) {
+            std::cerr << colorize("  [WARN]", Color::YELLOW) << " --time-report builds locally, ignoring --workers" << std::endl;
+            return remotes;
+        }
+        if (!workerAddresses.empty() && workerToken.empty()) {
+            std::cerr << colorize("  [WARN]", Color::YELLOW)
+                     << " --workers needs FOCAL_RUN_WORKER_TOKEN or --worker-token, building locally" << std::endl;
+            return remotes;
+        }
+        for (const auto& address : workerAddresses) {
+            size_t colon = address.rfind(':');
+            std::string host = colon == std::string::npos ? address : address.substr(0, colon);
+            std::string port = colon == std::string::npos ? "7420" : address.substr(colon + 1);
+
+            auto remote = std::make_unique<RemoteWorker>();
+            remote->address = address;
+            remote->fd = openSocket(host, port, false);
+            std::string buffer, hello;
+            if (remote->fd < 0 || !sendLine(remote->fd, "HELLO " + workerToken) ||
+                !readLine(remote->fd, buffer, hello) || hello.rfind("HELLO ", 0) != 0) {
+                std::cerr << colorize("  [WARN]", Color::YELLOW) << " Worker unreachable: " << address << std::endl;
+                if (remote->fd >= 0) close(remote->fd);
+                continue;
+            }
+
+            std::stringstream ss(hello.substr(6));
+            std::string field;
+            while (ss >> field) {
+                if (field.rfind("slots=", 0) == 0) remote->slots = std::max(1L, std::atol(field.c_str() + 6));
+                else if (field.rfind("host=", 0) == 0) remote->host = field.substr(5);
+            }
+            if (verboseMode) {
+                std::cout << colorize("  [REMOTE]", Color::CYAN) << " " << address << " (" << remote->host
+                         << "): " << remote->slots << " slots" << std::endl;
+            }
+            remotes.push_back(std::move(remote));
+        }
+#endif
+        return remotes;
+    }
+
+    bool buildProject(ProjectInfo& proj) {
+        if (proj.isMakefileProject) {
+            return buildMakefileProject(proj);
+        }
+
+        if (proj.buildSystem == BuildSystem::Rust) {
+            return buildRustProject(proj);
+        }
+
+        return buildCMakeProject(proj);
+    }
+
+    bool buildCMakeProject(ProjectInfo& proj) {
+        if (!configureCMakeProject(proj)) return false;
+        return !needsBuildStage(proj) || compileCMakeProject(proj);
+    }
+
+    // Projects whose configure step is followed by a separate compile step
+    bool needsBuildStage(const ProjectInfo& proj) {
+        return proj.buildSystem != BuildSystem::Rust && !proj.isMakefileProject && !cleanMode &&
+               !proj.restoredFromCache && !proj.reusedBuild &&
+               ninjaGraphPrefixes.find(proj.path) == ninjaGraphPrefixes.end();
+    }
+
+    // Configure stage: clean/rebuild handling and the cmake configure step
+    bool configureCMakeProject(ProjectInfo& proj) {
+        std::unique_lock<std::mutex> dirLock = lockBuildDir(proj);
+        std::unique_lock<std::mutex> lock(outputMutex);
+        
+        determineBuildSystem(proj);
+        std::string buildDir = cmakeBuildDir(proj);
+
+        // All configurations share one Ninja Multi-Config tree, configured by whichever copy runs first
+        bool sharedTree = multiConfigGenerator && !proj.config.empty();
+        if (sharedTree) {
+            proj.detectedGenerator = "Ninja Multi-Config";
+            if (configuredBuildDirs.count(buildDir)) {
+                if (verboseMode) {
+                    std::cout << colorize("  [CONFIG]", Color::CYAN) << " " << proj.name
+                             << ": reusing " << buildDir << std::endl;
+                }
+                return true;
+            }
+        }
+
+        // Clean mode
+        if (cleanMode) {
+            std::vector<std::string> dirsToClean = {buildDir, proj.path + "/release", proj.path + "/debug"};
+            bool cleanedAny = false;
+
+            for (const auto& dir : dirsToClean) {
+                if (fs::exists(dir)) {
+                    try {
+                        fs::remove_all(dir);
+                        std::cout << colorize("  [CLEAN]", Color::YELLOW) 
+                                 << " Cleaned: " << dir << std::endl;
+                        cleanedAny = true;
+                    } catch (const std::exception& e) {
+                        std::cerr << colorize("  [ERROR]", Color::RED) 
+                                 << " Cleaning " << dir << ": " << e.what() << std::endl;
+                    }
+                }
+            }
+
+            if (!cleanedAny) {
+                std::cout << colorize("  [INFO]", Color::BLUE) 
+                         << " No build directories to clean" << std::endl;
+            }
+            return true;
+        }
+
+        // Rebuild mode
+        if (rebuildMode && fs::exists(buildDir)) {
+            try {
+                fs::remove_all(buildDir);
+                std::cout << colorize("  [REBUILD]", Color::YELLOW) 
+                         << " Cleaned: " << buildDir << std::endl;
+            } catch (const std::exception& e) {
+                std::cerr << colorize("  [ERROR]", Color::RED) 
+                         << " Cleaning: " << e.what() << std::endl;
+                return false;
+            }
+        }
+
+        // Create build directory
+        if (!fs::exists(buildDir)) {
+            try {
+                fs::create_directories(buildDir);
+                if (verboseMode) {
+                    std::cout << colorize("  [CREATE]", Color::GREEN) 
+                             << " Build directory: " << buildDir << std::endl;
+                }
+            } catch (const std::exception& e) {
+                std::cerr << colorize("  [ERROR]", Color::RED) 
+                         << " Creating build dir: " << e.what() << std::endl;
+                return false;
+            }
+        }
+
+        // Verify CMakeLists.txt
+        std::string cmakeListsPath = proj.path + "/CMakeLists.txt";
+        if (!fs::exists(cmakeListsPath)) {
+            std::cerr << colorize("  [ERROR]", Color::RED) 
+                     << " CMakeLists.txt not found in " << proj.path << std::endl;
+            return false;
+        }
+
+        // Configure
+        std::string escapedPath = escapeShellArg(proj.path);
+        std::string escapedBuildDir = escapeShellArg(buildDir);
+        std::string configCmd = "cmake -S \"" + escapedPath + "\" -B \"" + escapedBuildDir
+                                + "\" -G \"" + proj.detectedGenerator + "\"";
+
+        if (timeReportMode) {
+            const char* cxx = getenv("CXX");
+            std::string flag = compilerIsClang(cxx && *cxx ? cxx : "c++") ? "-ftime-trace" : "-ftime-report";
+            std::string launcher = escapeShellArg(writeTimeLauncher(buildDir));
+            configCmd += " -DCMAKE_BUILD_TYPE=" + proj.buildType +
+                         " -DCMAKE_C_COMPILER_LAUNCHER=\"" + launcher + "\" -DCMAKE_CXX_COMPILER_LAUNCHER=\"" + launcher +
+                         "\" -DCMAKE_C_FLAGS=" + flag + " -DCMAKE_CXX_FLAGS=" + flag;
+        } else if (sharedTree) {
+            std::string types;
+            for (const auto& config : buildConfigs) types += (types.empty() ? "" : ";") + config;
+            configCmd += " -DCMAKE_CONFIGURATION_TYPES=\"" + escapeShellArg(types) + "\"";
+        } else if (!proj.config.empty()) {
+            configCmd += " -DCMAKE_BUILD_TYPE=\"" + escapeShellArg(proj.config) + "\"";
+        }
+
+        configCmd += tunedConfigureArgs(tuneOptions(proj), buildDir);
+
+        // Outputs are prefixed so build.ninja can be a subninja of the combined graph
+        auto graphPrefix = ninjaGraphPrefixes.find(proj.path);
+        if (graphPrefix != ninjaGraphPrefixes.end()) {
+            configCmd += " -DCMAKE_NINJA_OUTPUT_PATH_PREFIX=\"" + escapeShellArg(graphPrefix->second) + "\"";
+        }
+        
+        if (verboseMode) {
+            std::cout << colorize("  [CONFIG]", Color::CYAN) 
+                     << " Generator: " << proj.detectedGenerator << std::endl;
+            std::cout << colorize("  [CMD]", Color::MAGENTA) 
+                     << " " << configCmd << std::endl;
+        }
+
+        auto startTime = std::chrono::high_resolution_clock::now();
+        int configResult = runBuildCommand(proj, configCmd, lock);
+        auto endTime = std::chrono::high_resolution_clock::now();
+        proj.stats.configTime = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
+        proj.stats.totalTime = proj.stats.configTime;
+
+        if (verboseMode) {
+            std::cout << colorize("  [TIME]", Color::BLUE) 
+                     << " Configuration: " << proj.stats.configTime.count() << "ms" << std::endl;
+        }
+
+        if (configResult != 0) {
+            std::cerr << colorize("  [FAILED]", Color::RED) << " CMake configuration failed!" << std::endl;
+            std::cerr << "  Project: " << proj.path << std::endl;
+            std::cerr << "  Generator: " << proj.detectedGenerator << std::endl;
+            if (!verboseMode) {
+                std::cerr << "  Run with --verbose for details" << std::endl;
+            }
+            return false;
+        }
+
+        if (sharedTree) configuredBuildDirs.insert(buildDir);
+
+        // With --ninja-graph the compile step is the single combined Ninja invocation
+        return true;
+    }
+
+    // Build stage: compile an already configured CMake project
+    bool compileCMakeProject(ProjectInfo& proj) {
+        std::unique_lock<std::mutex> dirLock = lockBuildDir(proj);
+        std::unique_lock<std::mutex> lock(outputMutex);
+
+        std::string buildCmd = "cmake --build \"" + escapeShellArg(cmakeBuildDir(proj)) + "\" --config " + proj.buildType +
+                               tunedBuildArgs(tuneOptions(proj));
+        // Every translation unit is recompiled so the report covers the whole project
+        if (timeReportMode) buildCmd += " --clean-first";
+        auto traceStart = fs::file_time_type::clock::now();
+        
+        if (verboseMode) {
+            std::cout << colorize("  [BUILD]", Color::GREEN) << " " << proj.name << ": " << buildCmd << std::endl;
+        }
+
+        auto startTime = std::chrono::high_resolution_clock::now();
+        int buildResult = runBuildCommand(proj, buildCmd, lock);
+        auto endTime = std::chrono::high_resolution_clock::now();
+        proj.stats.buildTime = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
+        proj.stats.totalTime = proj.stats.configTime + proj.stats.buildTime;
+
+        if (timeReportMode) collectTimeReport(cmakeBuildDir(proj), proj.name, proj.path, traceStart);
+
+        if (verboseMode) {
+            std::cout << colorize("  [TIME]", Color::BLUE) 
+                     << " Build: " << proj.stats.buildTime.count() << "ms" << std::endl;
+            std::cout << colorize("  [TIME]", Color::BLUE) 
+                     << " Total: " << proj.stats.totalTime.count() << "ms" << std::endl;
+        }
+
+        if (buildResult != 0) {
+            std::cerr << colorize("  [FAILED]", Color::RED) << " Build failed: " << proj.name << std::endl;
+            if (!verboseMode) {
+                std::cerr << "  Run with --verbose for details" << std::endl;
+            }
+            return false;
+        }
+
+        return true;
+    }
+
+    // build/ (or the --build-root dir) normally; build/time-report for --time-report; with --configs either the shared Ninja Multi-Config tree
+    // build/multi or one single-configuration tree per configuration, build/<Config>
+    std::string cmakeBuildDir(const ProjectInfo& proj) {
+        if (!proj.buildDir.empty()) return proj.buildDir;
+        std::string base = buildRoot.empty() ? proj.path + "/build" : buildRootDir(proj);
+        if (timeReportMode) return base + "/time-report";
+        if (proj.config.empty()) return base;
+        return base + "/" + (multiConfigGenerator ? "multi" : proj.config);
+    }
+
+    // Ninja keeps one log and deps file per build dir: builds of a shared
+    // multi-config tree run one configuration at a time
+    std::unique_lock<std::mutex> lockBuildDir(const ProjectInfo& proj) {
+        if (!multiConfigGenerator || proj.config.empty()) return std::unique_lock<std::mutex>();
+        return std::unique_lock<std::mutex>(buildDirLocks[cmakeBuildDir(proj)]);
+    }
+
+    // CMake version check, e.g. 3.16 for unity builds
+    bool cmakeVersionAtLeast(int major, int minor) {
+        static const std::string version = captureCommand("cmake --version");
+        size_t pos = version.find("version ");
+        if (pos == std::string::npos) return false;
+        int foundMajor = std::atoi(version.c_str() + pos + 8);
+        size_t dot = version.find('.', pos);
+        int foundMinor = dot == std::string::npos ? 0 : std::atoi(version.c_str() + dot + 1);
+        return foundMajor > major || (foundMajor == major && foundMinor >= minor);
+    }
+
+    // Options chosen by --tune, stored as <path>_tune=generator=Ninja;jobs=8;unity=16;...
+    // Defaults (CMake's generator choice aside) are left out
+    std::map<std::string, std::string> tuneOptions(const ProjectInfo& proj) {
+        std::map<std::string, std::string> options;
+        auto cached = configCache.find(proj.path + "_tune");
+        if (cached == configCache.end()) return options;
+        for (const auto& option : splitList(cached->second, ';')) {
+            size_t eq = option.find('=');
+            if (eq != std::string::npos) options[option.substr(0, eq)] = option.substr(eq + 1);
+        }
+        return options;
+    }
+
+    static std::string formatTuneOptions(const std::map<std::string, std::string>& options) {
+        std::string text;
+        for (const auto& option : options) {
+            if (option.second.empty() || option.second == "0" || option.second == "off") continue;
+            text += (text.empty() ? "" : ";") + option.first + "=" + option.second;
+        }
+        return text;
+    }
+
+    // Configure arguments for tuned linker, unity batch and PCH options
+    std::string tunedConfigureArgs(const std::map<std::string, std::string>& options, const std::string& buildDir) {
+        std::string args;
+        auto option = options.find("linker");
+        if (option != options.end() && !option->second.empty()) {
+            std::string flag = "-fuse-ld=" + option->second;
+            args += " -DCMAKE_EXE_LINKER_FLAGS=" + flag + " -DCMAKE_SHARED_LINKER_FLAGS=" + flag +
+                    " -DCMAKE_MODULE_LINKER_FLAGS=" + flag;
+        }
+        option = options.find("unity");
+        if (option != options.end() && std::atoi(option->second.c_str()) > 0) {
+            args += " -DCMAKE_UNITY_BUILD=ON -DCMAKE_UNITY_BUILD_BATCH_SIZE=" + std::to_string(std::atoi(option->second.c_str()));
+        }
+        option = options.find("pch");
+        if (option != options.end() && option->second == "on") {
+            args += " -DCMAKE_PROJECT_INCLUDE=\"" + escapeShellArg(writePchScript(buildDir)) + "\"";
+        }
+        return args;
+    }
+
+    static std::string tunedBuildArgs(const std::map<std::string, std::string>& options) {
+        auto jobs = options.find("jobs");
+        if (jobs == options.end() || std::atoi(jobs->second.c_str()) <= 0) return "";
+        return " --parallel " + std::to_string(std::atoi(jobs->second.c_str()));
+    }
+
+    // CMAKE_PROJECT_INCLUDE script that precompiles common standard headers in
+    // every C++ target once the whole source tree has been processed (CMake 3.19)
+    std::string writePchScript(const std::string& buildDir) {
+        std::error_code ec;
+        fs::create_directories(buildDir, ec);
+        std::string path = fs::absolute(buildDir + "/focal-run-pch.cmake", ec).lexically_normal().string();
+        std::ofstream script(path);
+        script << "# Written by focal-run --tune\n"
+               << "if(CMAKE_VERSION VERSION_LESS 3.19)\n  return()\nendif()\n"
+               << "get_property(_focal_run_pch GLOBAL PROPERTY FOCAL_RUN_PCH)\n"
+               << "if(_focal_run_pch)\n  return()\nendif()\n"
+               << "set_property(GLOBAL PROPERTY FOCAL_RUN_PCH TRUE)\n"
+               << "function(_focal_run_pch_dir dir)\n"
+               << "  get_property(targets DIRECTORY \"${dir}\" PROPERTY BUILDSYSTEM_TARGETS)\n"
+               << "  foreach(target IN LISTS targets)\n"
+               << "    get_target_property(type ${target} TYPE)\n"
+               << "    if(type MATCHES \"^(EXECUTABLE|STATIC_LIBRARY|SHARED_LIBRARY|MODULE_LIBRARY|OBJECT_LIBRARY)$\")\n"
+               << "      target_precompile_headers(${target} PRIVATE\n";
+        for (const char* header : {"algorithm", "functional", "iostream", "map", "memory", "string", "unordered_map", "vector"}) {
+            script << "        \"$<$<COMPILE_LANGUAGE:CXX>:<" << header << ">>\"\n";
+        }
+        script << "      )\n"
+               << "    endif()\n"
+               << "  endforeach()\n"
+               << "  get_property(subdirs DIRECTORY \"${dir}\" PROPERTY SUBDIRECTORIES)\n"
+               << "  foreach(subdir IN LISTS subdirs)\n"
+               << "    _focal_run_pch_dir(\"${subdir}\")\n"
+               << "  endforeach()\n"
+               << "endfunction()\n"
+               << "function(_focal_run_pch)\n"
+               << "  _focal_run_pch_dir(\"${CMAKE_SOURCE_DIR}\")\n"
+               << "endfunction()\n"
+               << "cmake_language(DEFER DIRECTORY \"${CMAKE_SOURCE_DIR}\" CALL _focal_run_pch)\n";
+        return path;
+    }
+
+    // One --tune candidate in a scratch tree: a clean configure + build, then an
+    // incremental build after touching one source. The candidate goes through the
+    // normal configure and build stages, its options set as <path>_tune the way
+    // later builds read them. Returns false if it fails
+    bool measureTuneCandidate(const ProjectInfo& proj, const std::map<std::string, std::string>& options,
+                              const std::string& scratch, const std::string& touched, long& cleanMs, long& incrementalMs) {
+        std::error_code ec;
+        fs::remove_all(scratch, ec);
+
+        ProjectInfo candidate = proj;
+        candidate.buildDir = scratch;
+        candidate.config.clear();
+        candidate.stats = BuildStats();
+        configCache[proj.path + "_tune"] = formatTuneOptions(options);
+        if (!configureCMakeProject(candidate) || !compileCMakeProject(candidate)) return false;
+        cleanMs = (long)candidate.stats.totalTime.count();
+
+        // The original mtime is put back so the project does not look changed afterwards
+        incrementalMs = 0;
+        if (touched.empty()) return true;
+        auto mtime = fs::last_write_time(touched, ec);
+        fs::last_write_time(touched, fs::file_time_type::clock::now(), ec);
+        bool ok = compileCMakeProject(candidate);
+        incrementalMs = (long)candidate.stats.buildTime.count();
+        fs::last_write_time(touched, mtime, ec);
+        return ok;
+    }
+
+    static std::string describeTuneOptions(const std::map<std::string, std::string>& options) {
+        std::string text;
+        for (const auto& option : options) {
+            std::string value = option.second.empty() ? "default" : option.second;
+            if (option.first == "jobs" && value == "0") value = "default";
+            text += (text.empty() ? "" : " ") + option.first + "=" + value;
+        }
+        return text;
+    }
+
+    // --tune: coordinate descent over CMake build options. Starting from the
+    // defaults, each option in turn tries its alternatives with the others held at
+    // their best so far, so a project costs 1 + (alternatives) measurements rather
+    // than the full cross product. A candidate scores its clean plus incremental
+    // build time and must win by 3% to replace the incumbent. The winner is saved
+    // as <path>_tune next to <path>_generator and used by every later build
+    void tuneProject(ProjectInfo& proj) {
+        // What the existing build tree was configured with
+        std::map<std::string, std::string> previous = tuneOptions(proj);
+        auto cachedGenerator = configCache.find(proj.path + "_generator");
+        if (!previous.count("generator") && cachedGenerator != configCache.end()) {
+            previous["generator"] = cachedGenerator->second;
+        }
+        configCache.erase(proj.path + "_tune");
+        determineBuildSystem(proj);
+        unsigned int hwThreads = std::max(1u, std::thread::hardware_concurrency());
+
+        std::vector<std::pair<std::string, std::vector<std::string>>> dimensions;
+        if (detectGenerator(proj.path).empty()) {
+            std::vector<std::string> generators = {proj.detectedGenerator};
+            for (const char* generator : {"Ninja", "Unix Makefiles"}) {
+                bool available = isCommandAvailable(std::string(generator) == "Ninja" ? "ninja" : "make");
+                if (available && proj.detectedGenerator != generator) generators.push_back(generator);
+            }
+            dimensions.push_back({"generator", generators});
+        } else {
+            dimensions.push_back({"generator", {proj.detectedGenerator}});
+        }
+        std::vector<std::string> jobs = {"0", std::to_string(hwThreads)};
+        if (hwThreads >= 4) jobs.push_back(std::to_string(hwThreads / 2));
+        dimensions.push_back({"jobs", jobs});
+        std::vector<std::string> linkers = {""};
+        if (isCommandAvailable("mold")) linkers.push_back("mold");
+        if (isCommandAvailable("ld.lld")) linkers.push_back("lld");
+        dimensions.push_back({"linker", linkers});
+        if (cmakeVersionAtLeast(3, 16)) dimensions.push_back({"unity", {"0", "8", "16", "32"}});
+        if (cmakeVersionAtLeast(3, 19)) dimensions.push_back({"pch", {"off", "on"}});
+
+        // The largest C/C++ source stands in for a typical edit
+        std::string touched;
+        uintmax_t largest = 0;
+        forEachSourceFile(proj.path, declaredOutputs(proj), [&](const fs::directory_entry& entry) {
+            std::string ext = entry.path().extension().string();
+            if (ext != ".cpp" && ext != ".cc" && ext != ".cxx" && ext != ".c") return;
+            std::error_code ec;
+            uintmax_t size = entry.file_size(ec);
+            if (!ec && size > largest) {
+                largest = size;
+                touched = entry.path().string();
+            }
+        });
+
+        std::map<std::string, std::string> best;
+        for (const auto& dimension : dimensions) best[dimension.first] = dimension.second.front();
+        std::string scratch = cmakeBuildDir(proj) + "-tune";
+
+        auto report = [&](const std::map<std::string, std::string>& options, bool ok, long cleanMs, long incrementalMs) {
+            std::cout << colorize("  [TUNE]", Color::CYAN) << " " << proj.name << ": " << describeTuneOptions(options);
+            if (ok) {
+                std::cout << std::fixed << std::setprecision(1) << "  clean " << cleanMs / 1000.0
+                         << "s, incremental " << incrementalMs / 1000.0 << "s" << std::endl;
+            } else {
+                std::cout << colorize("  failed", Color::RED) << std::endl;
+            }
+        };
+
+        long cleanMs = 0, incrementalMs = 0;
+        bool ok = measureTuneCandidate(proj, best, scratch, touched, cleanMs, incrementalMs);
+        report(best, ok, cleanMs, incrementalMs);
+        if (!ok) {
+            std::cerr << colorize("  [FAILED]", Color::RED) << " " << proj.name
+                     << " does not build with default options, not tuned" << std::endl;
+            configCache.erase(proj.path + "_tune");
+            std::error_code ec;
+            fs::remove_all(scratch, ec);
+            return;
+        }
+        long baselineMs = cleanMs + incrementalMs;
+        long bestMs = baselineMs;
+
+        for (const auto& dimension : dimensions) {
+            std::string incumbent = best[dimension.first];
+            for (const auto& value : dimension.second) {
+                if (value == incumbent) continue;
+                std::map<std::string, std::string> candidate = best;
+                candidate[dimension.first] = value;
+                ok = measureTuneCandidate(proj, candidate, scratch, touched, cleanMs, incrementalMs);
+                report(candidate, ok, cleanMs, incrementalMs);
+                if (ok && cleanMs + incrementalMs < bestMs * 0.97) {
+                    best = candidate;
+                    bestMs = cleanMs + incrementalMs;
+                }
+            }
+        }
+
+        std::error_code ec;
+        fs::remove_all(scratch, ec);
+
+        // The build tree is reconfigured from scratch only if its options changed
+        std::string formatted = formatTuneOptions(best);
+        if (formatTuneOptions(previous) != formatted) fs::remove_all(cmakeBuildDir(proj), ec);
+        configCache[proj.path + "_tune"] = formatted;
+        configCache[proj.path + "_generator"] = best["generator"];
+        std::cout << colorize("  [TUNE]", Color::GREEN) << " " << proj.name << ": best "
+                 << (formatted.empty() ? "defaults" : describeTuneOptions(best)) << std::fixed << std::setprecision(1)
+                 << " (" << bestMs / 1000.0 << "s vs " << baselineMs / 1000.0 << "s with defaults)" << std::endl;
+    }
+
+    void tuneProjects() {
+        std::set<std::string> tuned;
+        for (auto& proj : projects) {
+            if (proj.buildSystem == BuildSystem::Rust || proj.isMakefileProject) {
+                std::cerr << colorize("  [WARN]", Color::YELLOW) << " " << proj.name
+                         << ": --tune only covers CMake projects, skipped" << std::endl;
+                continue;
+            }
+            // --configs copies share one entry per path
+            if (!tuned.insert(proj.path).second) continue;
+            tuneProject(proj);
+        }
+        saveConfigCache();
+    }
+
+    // --configs: one copy of every CMake and Cargo project per configuration,
+    // scheduled like separate projects. Makefile projects have no configuration
+    // and are built once.
+    void expandConfigurations() {
+        if (buildConfigs.empty() || cleanMode) return;
+        if (timeReportMode) {
+            std::cerr << colorize("  [WARN]", Color::YELLOW)
+                     << " --configs is ignored with --time-report" << std::endl;
+            return;
+        }
+
+        // Ninja Multi-Config needs CMake 3.17
+        multiConfigGenerator = isCommandAvailable("ninja") && cmakeVersionAtLeast(3, 17);
+
+        if (ninjaGraphMode) {
+            std::cerr << colorize("  [WARN]", Color::YELLOW)
+                     << " --ninja-graph is not supported with --configs, building projects separately" << std::endl;
+            ninjaGraphMode = false;
+        }
+
+        std::vector<ProjectInfo> expanded;
+        for (const auto& proj : projects) {
+            if (proj.isMakefileProject) {
+                expanded.push_back(proj);
+                continue;
+            }
+            for (const auto& config : buildConfigs) {
+                ProjectInfo copy = proj;
+                copy.config = config;
+                copy.buildType = config;
+                copy.name = proj.name + " [" + config + "]";
+                expanded.push_back(copy);
+                if (copy.buildSystem != BuildSystem::Rust) buildDirLocks[cmakeBuildDir(copy)];
+            }
+        }
+        projects = std::move(expanded);
+
+        if (verboseMode) {
+            std::cout << colorize("  [CONFIGS]", Color::CYAN) << " " << buildConfigs.size()
+                     << " configurations, " << projects.size() << " builds ("
+                     << (multiConfigGenerator ? "Ninja Multi-Config, one configure per project"
+                                              : "one build dir per configuration")
+                     << ")" << std::endl;
+        }
+    }
+
+    // --build-root: each project builds in <root>/<dir name>-<hash of its source path>,
+    // named in a .focal-run-source manifest. Assigned before building, read-only after.
+    std::string buildRootDir(const ProjectInfo& proj) {
+        auto mapped = buildRootDirs.find(normalizePath(proj.path));
+        return mapped != buildRootDirs.end() ? mapped->second : mapBuildRootDir(normalizePath(proj.path));
+    }
+
+    std::string mapBuildRootDir(const std::string& source) {
+        std::string name;
+        for (char c : fs::path(source).filename().string()) {
+            name += std::isalnum(static_cast<unsigned char>(c)) || c == '-' || c == '_' ? c : '_';
+        }
+        std::string hash = hashString(source);
+        std::string dir = buildRoot + "/" + (name.empty() ? "root" : name) + "-" + hash.substr(0, 8);
+
+        // A short-hash collision with another source tree takes the full hash
+        std::ifstream manifest(dir + "/.focal-run-source");
+        std::string recorded;
+        if (std::getline(manifest, recorded) && recorded != source) dir += hash.substr(8);
+        return dir;
+    }
+
+    // Map every project to its build root dir; with create, also write the
+    // manifests (their mtime is the last use, for --build-root-quota) and
+    // point Cargo projects without a shared target dir into it
+    void prepareBuildRoot(bool create) {
+        if (buildRoot.empty()) return;
+        for (auto& proj : projects) {
+            std::string source = normalizePath(proj.path);
+            if (!buildRootDirs.count(source)) buildRootDirs[source] = mapBuildRootDir(source);
+            std::string dir = buildRootDirs[source];
+            if (proj.buildSystem == BuildSystem::Rust && proj.cargoTargetDir.empty()) {
+                proj.cargoTargetDir = dir + "/target";
+                targetDirLocks[proj.cargoTargetDir];
+            }
+            if (!create) continue;
+
+            std::error_code ec;
+            fs::create_directories(dir, ec);
+            if (ec) {
+                throw FocalRunError("Cannot create build root dir " + dir + ": " + ec.message());
+            }
+            std::ofstream(dir + "/.focal-run-source") << source << std::endl;
+            if (verboseMode) {
+                std::cout << colorize("  [BUILD-ROOT]", Color::CYAN) << " " << proj.name << " -> " << dir << std::endl;
+            }
+        }
+        if (create) enforceBuildRootQuota(false);
+    }
+
+    static unsigned long long directorySize(const fs::path& dir) {
+        unsigned long long size = 0;
+        std::error_code ec;
+        for (auto it = fs::recursive_directory_iterator(dir, ec); !ec && it != fs::recursive_directory_iterator();
+             it.increment(ec)) {
+            if (it->is_regular_file(ec) && !it->is_symlink(ec)) size += it->file_size(ec);
+        }
+        return size;
+    }
+
+    // Keep the build root under --build-root-quota by removing the least
+    // recently used project dirs; dirs of the current run are never removed
+    void enforceBuildRootQuota(bool warnOverQuota) {
+        if (buildRoot.empty() || buildRootQuota == 0) return;
+        std::unordered_set<std::string> inUse;
+        for (const auto& mapped : buildRootDirs) inUse.insert(fs::path(mapped.second).lexically_normal().string());
+
+        std::vector<std::tuple<fs::file_time_type, unsigned long long, fs::path>> entries;
+        unsigned long long total = 0;
+        std::error_code ec;
+        for (const auto& entry : fs::directory_iterator(buildRoot, ec)) {
+            fs::path manifest = entry.path() / ".focal-run-source";
+            if (!fs::exists(manifest, ec)) continue;
+            unsigned long long size = directorySize(entry.path());
+            total += size;
+            if (inUse.count(entry.path().lexically_normal().string())) continue;
+            entries.emplace_back(fs::last_write_time(manifest, ec), size, entry.path());
+        }
+
+        std::sort(entries.begin(), entries.end());
+        for (const auto& entry : entries) {
+            if (total <= buildRootQuota) break;
+            fs::remove_all(std::get<2>(entry), ec);
+            total -= std::get<1>(entry);
+            if (verboseMode) {
+                std::cout << colorize("  [BUILD-ROOT]", Color::YELLOW) << " Evicted "
+                         << std::get<2>(entry).filename().string() << std::endl;
+            }
+        }
+
+        if (warnOverQuota && total > buildRootQuota) {
+            std::cerr << colorize("  [WARN]", Color::YELLOW) << " Build root uses " << total / (1024 * 1024)
+                     << " MB, over its quota of " << buildRootQuota / (1024 * 1024)
+                     << " MB with only this run's projects left" << std::endl;
+        }
+    }
+
+    // Directories a project builds into, whether or not they exist yet. For
+    // Makefile projects only the ones --clean --all removes, plus any declared with
+    // "# Focal-Outputs:"; --gc deletes these, so nothing is guessed
+    std::vector<std::string> projectBuildDirs(const ProjectInfo& proj) {
+        if (proj.buildSystem == BuildSystem::Rust) {
+            if (sharedTargetMode) return {};
+            return {proj.cargoTargetDir.empty() ? proj.path + "/target" : proj.cargoTargetDir};
+        }
+        if (!buildRoot.empty()) return {buildRootDir(proj)};
+        if (!proj.isMakefileProject) return {proj.path + "/build"};
+        std::vector<std::string> outputs = {"build", "release", "debug"};
+        for (const auto& output : manifestOutputs(proj)) {
+            if (std::find(outputs.begin(), outputs.end(), output) == outputs.end()) outputs.push_back(output);
+        }
+        std::vector<std::string> dirs;
+        for (const auto& output : outputs) dirs.push_back(proj.path + "/" + output);
+        return dirs;
+    }
+
+    // Cargo data that can go without a cold build: per crate, every incremental
+    // cache but the newest and every session in it but the newest
+    static std::vector<fs::path> staleIncrementalData(const fs::path& targetDir) {
+        std::vector<fs::path> stale;
+        std::error_code ec;
+        auto newestFirst = [](std::vector<fs::path>& paths) {
+            std::error_code ec;
+            std::sort(paths.begin(), paths.end(), [&ec](const fs::path& a, const fs::path& b) {
+                return fs::last_write_time(a, ec) > fs::last_write_time(b, ec);
+            });
+        };
+        for (const auto& profile : fs::directory_iterator(targetDir, ec)) {
+            fs::path incremental = profile.path() / "incremental";
+            if (!fs::is_directory(incremental, ec)) continue;
+
+            std::map<std::string, std::vector<fs::path>> byCrate;
+            for (const auto& entry : fs::directory_iterator(incremental, ec)) {
+                std::string name = entry.path().filename().string();
+                byCrate[name.substr(0, name.rfind('-'))].push_back(entry.path());
+            }
+            for (auto& crate : byCrate) {
+                newestFirst(crate.second);
+                stale.insert(stale.end(), crate.second.begin() + 1, crate.second.end());
+
+                std::vector<fs::path> sessions;
+                for (const auto& entry : fs::directory_iterator(crate.second.front(), ec)) {
+                    if (entry.is_directory(ec) && entry.path().filename().string().rfind("s-", 0) == 0) {
+                        sessions.push_back(entry.path());
+                    }
+                }
+                if (sessions.size() < 2) continue;
+                newestFirst(sessions);
+                // Session s-<time>-<random>-<svh> is locked by s-<time>-<random>.lock
+                for (size_t i = 1; i < sessions.size(); ++i) {
+                    std::string name = sessions[i].filename().string();
+                    stale.push_back(sessions[i]);
+                    stale.push_back(sessions[i].parent_path() / (name.substr(0, name.rfind('-')) + ".lock"));
+                }
+            }
+        }
+        return stale;
+    }
+
+    // --gc=<size>: bring the projects' build dirs under a disk budget while
+    // keeping recently built projects warm. Cheapest losses go first: stale
+    // cargo incremental data, then the cargo profile the current mode does not
+    // build, then whole build dirs, least recently built first. Projects another
+    // focal-run is building right now are left alone; the locks of every other
+    // tree, per-config ones included, stay held until the removals are done
+    void collectGarbage() {
+        struct Eviction {
+            int tier;
+            long long lastBuilt;
+            std::string project;
+            std::string what;
+            std::vector<fs::path> paths;
+            unsigned long long size;
+        };
+
+        std::vector<Eviction> evictions;
+        std::set<std::string> seen;
+        std::map<std::string, std::unique_ptr<FileLock>> held;
+        unsigned long long total = 0;
+        size_t measured = 0;
+        std::error_code ec;
+        fs::create_directories(lockDir(), ec);
+        for (const auto& proj : projects) {
+            std::vector<std::string> dirs;
+            for (const auto& dir : projectBuildDirs(proj)) {
+                if (fs::is_directory(dir, ec) && seen.insert(normalizePath(dir)).second) dirs.push_back(dir);
+            }
+            if (dirs.empty()) continue;
+
+            unsigned long long size = 0;
+            for (const auto& dir : dirs) size += directorySize(dir);
+            total += size;
+            measured++;
+
+            std::vector<std::string> taken;
+            bool busy = false;
+            for (const auto& path : treeLockPaths(proj)) {
+                if (held.count(path)) continue;
+                auto lock = std::make_unique<FileLock>();
+                if (!lock->acquire(path, false)) {
+                    busy = true;
+                    break;
+                }
+                held[path] = std::move(lock);
+                taken.push_back(path);
+            }
+            if (busy) {
+                for (const auto& path : taken) held.erase(path);
+                std::cout << colorize("  [GC]", Color::YELLOW) << " " << proj.name
+                         << ": being built by another focal-run, kept" << std::endl;
+                continue;
+            }
+
+            // Recorded build time, else the build dir's mtime
+            long long lastBuilt = 0;
+            auto recorded = configCache.find(proj.path + "_lastBuilt");
+            if (recorded != configCache.end()) {
+                lastBuilt = std::atoll(recorded->second.c_str());
+            } else {
+                auto age = fs::file_time_type::clock::now() - fs::last_write_time(dirs.front(), ec);
+                lastBuilt = (long long)std::chrono::system_clock::to_time_t(
+                    std::chrono::system_clock::now() - std::chrono::duration_cast<std::chrono::system_clock::duration>(age));
+            }
+
+            if (proj.buildSystem == BuildSystem::Rust) {
+                std::vector<fs::path> stale = staleIncrementalData(dirs.front());
+                unsigned long long staleSize = 0;
+                for (const auto& path : stale) staleSize += fs::is_directory(path, ec) ? directorySize(path) : fs::file_size(path, ec);
+                if (!stale.empty()) evictions.push_back({0, lastBuilt, proj.name, "stale incremental data", stale, staleSize});
+
+                std::string inactive = cargoProfileFlag(proj).empty() ? "release" : "debug";
+                fs::path profile = fs::path(dirs.front()) / inactive;
+                if (fs::is_directory(profile, ec)) {
+                    evictions.push_back({1, lastBuilt, proj.name, "target/" + inactive + ", not the active profile",
+                                         {profile}, directorySize(profile)});
+                }
+            }
+
+            std::string what;
+            for (const auto& dir : dirs) {
+                what += (what.empty() ? "" : ", ") + (buildRoot.empty() ? fs::relative(dir, proj.path, ec).generic_string() : dir);
+            }
+            std::vector<fs::path> paths(dirs.begin(), dirs.end());
+            evictions.push_back({2, lastBuilt, proj.name, what, paths, size});
+        }
+
+        std::cout << "\n" << colorize("=== Garbage Collection ===", Color::BOLD + Color::CYAN) << std::endl;
+        std::cout << "  Build dirs: " << total / (1024 * 1024) << " MB in " << measured << " projects, budget "
+                 << gcBudget / (1024 * 1024) << " MB" << std::endl;
+        if (total <= gcBudget) {
+            std::cout << colorize("  Within budget, nothing removed", Color::GREEN) << std::endl;
+            return;
+        }
+
+        std::stable_sort(evictions.begin(), evictions.end(), [](const Eviction& a, const Eviction& b) {
+            return a.tier != b.tier ? a.tier < b.tier : a.lastBuilt < b.lastBuilt;
+        });
+
+        // A whole dir is measured again if an earlier tier already took part of it
+        std::set<std::string> pruned;
+        for (const auto& eviction : evictions) {
+            if (total <= gcBudget) break;
+            unsigned long long size = eviction.size;
+            if (eviction.tier == 2 && pruned.count(eviction.project)) {
+                size = 0;
+                for (const auto& path : eviction.paths) size += directorySize(path);
+            }
+            for (const auto& path : eviction.paths) fs::remove_all(path, ec);
+            total -= std::min(total, size);
+            pruned.insert(eviction.project);
+
+            char when[32] = "";
+            std::time_t lastBuilt = (std::time_t)eviction.lastBuilt;
+            std::strftime(when, sizeof(when), "%Y-%m-%d", std::localtime(&lastBuilt));
+            std::cout << colorize("  [GC]", Color::YELLOW) << " " << eviction.project << ": "
+                     << (eviction.tier == 0 ? "pruned " : "removed ") << eviction.what
+                     << " (" << size / (1024 * 1024) << " MB, last built " << when << ")" << std::endl;
+        }
+
+        std::cout << "  Now: " << total / (1024 * 1024) << " MB";
+        if (total > gcBudget) std::cout << colorize(" (still over budget)", Color::YELLOW);
+        std::cout << std::endl;
+    }
+
+    // --clean --all: build root dirs whose sources are under the scanned path
+    void cleanBuildRoot() {
+        std::string scanned = normalizePath(customPath);
+        std::error_code ec;
+        for (const auto& entry : fs::directory_iterator(buildRoot, ec)) {
+            std::ifstream manifest(entry.path() / ".focal-run-source");
+            std::string source;
+            if (!std::getline(manifest, source)) continue;
+            if (source != scanned && source.rfind(scanned + "/", 0) != 0) continue;
+
+            fs::remove_all(entry.path(), ec);
+            cleanedBuildDirs.push_back(entry.path().string());
+            std::cout << colorize("  [CLEAN]", Color::YELLOW) << " " << entry.path().string()
+                     << " (" << source << ")" << std::endl;
+        }
+    }
+
+    // Whether a compiler driver is clang: it writes -ftime-trace JSON, gcc prints a -ftime-report table
+    bool compilerIsClang(const std::string& compiler) {
+        auto cached = clangCompilers.find(compiler);
+        if (cached != clangCompilers.end()) return cached->second;
+        bool clang = captureCommand(compiler + " --version").find("clang") != std::string::npos;
+        clangCompilers[compiler] = clang;
+        return clang;
+    }
+
+    // Compiler launcher for --time-report: times each compile and keeps its
+    // stderr (gcc's -ftime-report table) in <dir>/timings, one file per TU.
+    // Timings from earlier runs are removed.
+    std::string writeTimeLauncher(const std::string& buildDir) {
+        std::string dir = fs::absolute(buildDir).lexically_normal().string();
+        std::error_code ec;
+        fs::remove_all(dir + "/timings", ec);
+        fs::create_directories(dir + "/timings", ec);
+
+        std::string launcher = dir + "/focal-run-time-launcher.sh";
+        std::ofstream script(launcher);
+        script << "#!/bin/sh\n"
+               << "start=$(date +%s%N)\n"
+               << "out=\"" << dir << "/timings/$$-$start\"\n"
+               << "\"$@\" 2>\"$out.err\"\n"
+               << "rc=$?\n"
+               << "end=$(date +%s%N)\n"
+               << "{\n"
+               << "    echo \"ms $(( (end - start) / 1000000 ))\"\n"
+               << "    for arg in \"$@\"; do\n"
+               << "        case \"$arg\" in *.c|*.cc|*.cpp|*.cxx|*.c++|*.C) echo \"tu $arg\" ;; esac\n"
+               << "    done\n"
+               << "    cat \"$out.err\"\n"
+               << "} > \"$out.txt\"\n"
+               << "sed '/^Time variable/,/^ TOTAL/d' \"$out.err\" >&2\n"
+               << "rm -f \"$out.err\"\n"
+               << "exit $rc\n";
+        script.close();
+        fs::permissions(launcher, fs::perms::owner_all | fs::perms::group_read | fs::perms::group_exec |
+                        fs::perms::others_read | fs::perms::others_exec, ec);
+        return launcher;
+    }
+
+    // Minimal JSON reader for tool output (ctest --show-only=json-v1, cargo
+    // messages, -ftime-trace files). \uXXXX escapes are kept as '?'.
+    static bool parseJsonValue(const std::string& text, size_t& pos, JsonValue& value) {
+        auto skipSpace = [&]() {
+            while (pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos]))) ++pos;
+        };
+        auto readString = [&](std::string& out) {
+            out.clear();
+            if (pos >= text.size() || text[pos] != '"') return false;
+            for (++pos; pos < text.size() && text[pos] != '"'; ++pos) {
+                if (text[pos] != '\\') {
+                    out += text[pos];
+                    continue;
+                }
+                if (++pos >= text.size()) return false;
+                char escaped = text[pos];
+                if (escaped == 'u') {
+                    out += '?';
+                    pos += 4;
+                } else {
+                    out += escaped == 'n' ? '\n' : escaped == 't' ? '\t' : escaped;
+                }
+            }
+            return pos++ < text.size();
+        };
+
+        skipSpace();
+        if (pos >= text.size()) return false;
+        char c = text[pos];
+        if (c == '"') {
+            value.type = JsonValue::Type::String;
+            return readString(value.text);
+        }
+        if (c == '{' || c == '[') {
+            bool object = c == '{';
+            char close = object ? '}' : ']';
+            value.type = object ? JsonValue::Type::Object : JsonValue::Type::Array;
+            ++pos;
+            skipSpace();
+            if (pos < text.size() && text[pos] == close) return ++pos, true;
+            while (pos < text.size()) {
+                std::string key;
+                if (object) {
+                    skipSpace();
+                    if (!readString(key)) return false;
+                    skipSpace();
+                    if (pos >= text.size() || text[pos++] != ':') return false;
+                }
+                JsonValue item;
+                if (!parseJsonValue(text, pos, item)) return false;
+                if (object) value.members.emplace_back(key, std::move(item));
+                else value.items.push_back(std::move(item));
+                skipSpace();
+                if (pos < text.size() && text[pos] == ',') {
+                    ++pos;
+                    continue;
+                }
+                return pos < text.size() && text[pos++] == close;
+            }
+            return false;
+        }
+
+        size_t end = pos;
+        while (end < text.size() && text[end] != ',' && text[end] != '}' && text[end] != ']' &&
+               !std::isspace(static_cast<unsigned char>(text[end]))) ++end;
+        std::string literal = text.substr(pos, end - pos);
+        pos = end;
+        if (literal == "null") return true;
+        if (literal == "true" || literal == "false") {
+            value.type = JsonValue::Type::Bool;
+            value.number = literal == "true";
+            return true;
+        }
+        char* parsed = nullptr;
+        value.type = JsonValue::Type::Number;
+        value.number = std::strtod(literal.c_str(), &parsed);
+        return !literal.empty() && parsed == literal.c_str() + literal.size();
+    }
+
+    static bool parseJson(const std::string& text, JsonValue& value) {
+        size_t pos = 0;
+        return parseJsonValue(text, pos, value);
+    }
+
+    // Calls onEvent(name, args.detail, dur in us) for every entry of a -ftime-trace
+    // file's traceEvents array. Returns false on malformed JSON.
+    static bool readTimeTrace(const std::string& text,
+                              const std::function<void(const std::string&, const std::string&, long)>& onEvent) {
+        JsonValue trace;
+        if (!parseJson(text, trace)) return false;
+        const JsonValue* events = trace.find("traceEvents");
+        if (!events) return false;
+        for (const auto& event : events->items) {
+            const JsonValue* args = event.find("args");
+            const JsonValue* duration = event.find("dur");
+            onEvent(event.str("name"), args ? args->str("detail") : "", duration ? (long)duration->number : 0);
+        }
+        return true;
+    }
+
+    // Add one build's timings to the report: launcher files for every TU's wall
+    // time and gcc phases, and clang traces written since the compile started
+    void collectTimeReport(const std::string& dir, const std::string& project, const std::string& sourceRoot,
+                           fs::file_time_type since) {
+        std::error_code ec;
+        for (const auto& entry : fs::directory_iterator(dir + "/timings", ec)) {
+            if (entry.path().extension() != ".txt") continue;
+            std::ifstream timing(entry.path());
+            std::string line, unit;
+            double ms = 0.0;
+            bool inTable = false;
+            while (std::getline(timing, line)) {
+                if (line.rfind("ms ", 0) == 0) ms = std::atof(line.c_str() + 3);
+                else if (line.rfind("tu ", 0) == 0 && unit.empty()) unit = line.substr(3);
+                else if (line.rfind("Time variable", 0) == 0) inTable = true;
+                else if (inTable) {
+                    size_t colon = line.find(':');
+                    if (colon == std::string::npos) continue;
+                    std::string phase = line.substr(0, colon);
+                    phase.erase(0, phase.find_first_not_of(" |"));
+                    phase.erase(phase.find_last_not_of(' ') + 1);
+                    if (phase == "TOTAL") {
+                        inTable = false;
+                        continue;
+                    }
+                    // usr, sys, wall, GGC columns; percentages in parentheses are skipped
+                    std::istringstream columns(line.substr(colon + 1));
+                    std::vector<double> values;
+                    std::string token;
+                    while (columns >> token) {
+                        if (token[0] == '(' || token.back() == ')') continue;
+                        values.push_back(std::atof(token.c_str()));
+                    }
+                    if (values.size() >= 3 && values[2] > 0.0) {
+                        timeReportPhases[phase].ms += values[2] * 1000.0;
+                        timeReportPhases[phase].count++;
+                    }
+                }
+            }
+            if (unit.empty()) continue;
+
+            fs::path relative = fs::relative(fs::absolute(unit, ec), fs::absolute(sourceRoot, ec), ec);
+            std::string shown = ec || relative.empty() || relative.string().substr(0, 2) == ".." ? unit : relative.string();
+            TimeTotal& total = timeReportUnits[project.empty() ? shown : project + ": " + shown];
+            total.ms += ms;
+            total.count++;
+        }
+
+        for (auto it = fs::recursive_directory_iterator(dir, ec); it != fs::recursive_directory_iterator(); it.increment(ec)) {
+            if (ec) break;
+            if (it->path().extension() != ".json" || !it->is_regular_file()) continue;
+            if (fs::last_write_time(it->path(), ec) < since) continue;
+
+            std::ifstream file(it->path());
+            std::stringstream content;
+            content << file.rdbuf();
+            std::string text = content.str();
+            if (text.find("\"traceEvents\"") == std::string::npos) continue;
+
+            readTimeTrace(text, [this](const std::string& name, const std::string& detail, long durationUs) {
+                if (detail.empty() || durationUs <= 0) return;
+                std::map<std::string, TimeTotal>* totals = nullptr;
+                if (name == "Source") totals = &timeReportHeaders;
+                else if (name == "InstantiateClass" || name == "InstantiateFunction") totals = &timeReportTemplates;
+                if (!totals) return;
+                (*totals)[detail].ms += durationUs / 1000.0;
+                (*totals)[detail].count++;
+            });
+        }
+    }
+
+    // Ranked --time-report tables over every project and file built in this run
+    void printTimeReport() {
+        if (timeReportUnits.empty()) {
+            std::cout << colorize("[TIME-REPORT]", Color::YELLOW)
+                     << " No compiler timings collected (only CMake projects and standalone files are measured)" << std::endl;
+            return;
+        }
+
+        auto printTop = [this](const std::string& title, const std::map<std::string, TimeTotal>& totals, bool counts) {
+            if (totals.empty()) return;
+            std::vector<std::pair<std::string, TimeTotal>> ranked(totals.begin(), totals.end());
+            std::sort(ranked.begin(), ranked.end(),
+                      [](const auto& a, const auto& b) { return a.second.ms > b.second.ms; });
+            if (ranked.size() > 10) ranked.resize(10);
+
+            std::cout << "\n  " << colorize(title, Color::BOLD) << std::endl;
+            for (const auto& entry : ranked) {
+                std::cout << "    " << std::fixed << std::setprecision(2) << std::setw(8)
+                         << entry.second.ms / 1000.0 << "s  " << entry.first;
+                if (counts) std::cout << colorize("  (x" + std::to_string(entry.second.count) + ")", Color::CYAN);
+                std::cout << std::endl;
+            }
+        };
+
+        std::cout << "\n" << colorize("=== Compile Time Report ===", Color::BOLD + Color::CYAN) << std::endl;
+        printTop("Slowest translation units:", timeReportUnits, false);
+        printTop("Most expensive headers (total parse time, includes nested headers):", timeReportHeaders, true);
+        printTop("Slowest template instantiations:", timeReportTemplates, true);
+        printTop("Compiler phases (gcc -ftime-report, wall time):", timeReportPhases, false);
+        if (timeReportHeaders.empty() && !timeReportPhases.empty()) {
+            std::cout << "\n  " << colorize("Note:", Color::BLUE)
+                     << " per-header and template times need clang (-ftime-trace)" << std::endl;
+        }
+        std::cout << std::endl;
+    }
+
+    bool buildRustProject(ProjectInfo& proj) {
+        std::unique_lock<std::mutex> targetLock = lockTargetDir(proj);
+        std::unique_lock<std::mutex> lock(outputMutex);
+
+        if (cleanMode) {
+            // A shared target dir holds other projects' artifacts: clean only this package
+            std::string cleanCmd = cargoInvocation(proj) + "clean";
+            if (sharedTargetMode && !proj.cargoTargetDir.empty()) {
+                cleanCmd += " -p " + (proj.packageName.empty() ? proj.name : proj.packageName);
+                if (buildType == "Release") cleanCmd += " --release";
+            }
+            
+            if (verboseMode) {
+                std::cout << colorize("  [CLEAN]", Color::YELLOW) << " " << cleanCmd << std::endl;
+            }
+
+            auto startTime = std::chrono::high_resolution_clock::now();
+            int cleanResult = runBuildCommand(proj, cleanCmd, lock);
+            auto endTime = std::chrono::high_resolution_clock::now();
+            auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
+
+            if (verboseMode) {
+                std::cout << colorize("  [TIME]", Color::BLUE) 
+                         << " Clean: " << duration.count() << "ms" << std::endl;
+            }
+
+            if (cleanResult != 0) {
+                std::cerr << colorize("  [FAILED]", Color::RED) << " Clean failed!" << std::endl;
+                return false;
+            }
+            return true;
+        }
+
+        std::string buildCmd = cargoInvocation(proj) + cargoCommand + cargoProfileFlag(proj);
+
+        if (verboseMode) {
+            std::cout << colorize("  [CARGO]", Color::GREEN) << " " << buildCmd << std::endl;
+        }
+
+        auto startTime = std::chrono::high_resolution_clock::now();
+        int buildResult = runBuildCommand(proj, buildCmd, lock);
+        auto endTime = std::chrono::high_resolution_clock::now();
+        proj.stats.buildTime = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
+        proj.stats.totalTime = proj.stats.buildTime;
+
+        if (verboseMode) {
+            std::cout << colorize("  [TIME]", Color::BLUE) 
+                     << " Build: " << proj.stats.buildTime.count() << "ms" << std::endl;
+        }
+
+        if (buildResult != 0) {
+            std::cerr << colorize("  [FAILED]", Color::RED) << " Build failed!" << std::endl;
+            return false;
+        }
+
+        return true;
+    }
+
+    // "cd <dir> && [env] cargo " with the shared target dir / sccache settings
+    std::string cargoInvocation(const ProjectInfo& proj) {
+        std::string cmd = "cd \"" + escapeShellArg(proj.path) + "\" && ";
+        std::vector<std::pair<std::string, std::string>> env;
+        if (!proj.cargoTargetDir.empty()) env.push_back({"CARGO_TARGET_DIR", proj.cargoTargetDir});
+        if (sccacheMode) env.push_back({"RUSTC_WRAPPER", "sccache"});
+        for (const auto& var : env) {
+#ifdef _WIN32
+            cmd += "set \"" + var.first + "=" + var.second + "\" && ";
+#else
+            cmd += var.first + "=\"" + escapeShellArg(var.second) + "\" ";
+#endif
+        }
+        return cmd + "cargo ";
+    }
+
+    // Find the rust-toolchain file rustup would apply in this directory
+    static std::string findToolchainFile(const std::string& path) {
+        for (fs::path dir = fs::absolute(path); ; dir = dir.parent_path()) {
+            for (const char* name : {"rust-toolchain.toml", "rust-toolchain"}) {
+                if (fs::exists(dir / name)) return (dir / name).string();
+            }
+            if (dir == dir.parent_path()) return "";
+        }
+    }
+
+    // Map compatible Rust projects (same toolchain and RUSTFLAGS) to one shared target dir
+    void prepareSharedTargets() {
+        if (!sharedTargetMode) return;
+        if (sccacheMode && !isCommandAvailable("sccache")) {
+            std::cerr << colorize("  [WARN]", Color::YELLOW) << " sccache not found, building without it" << std::endl;
+            sccacheMode = false;
+        }
+
+        std::string base = sharedTargetRoot.empty() ? userCacheDir() + "/cargo-target" : sharedTargetRoot;
+        const char* rustflags = getenv("RUSTFLAGS");
+        std::unordered_map<std::string, std::string> versionByToolchain;
+
+        for (auto& proj : projects) {
+            if (proj.buildSystem != BuildSystem::Rust) continue;
+
+            std::string toolchainFile = findToolchainFile(proj.path);
+            std::string toolchain;
+            if (!toolchainFile.empty()) {
+                std::ifstream file(toolchainFile);
+                std::stringstream content;
+                content << file.rdbuf();
+                toolchain = content.str();
+            }
+
+            if (!versionByToolchain.count(toolchain)) {
+                versionByToolchain[toolchain] =
+                    captureCommand("cd \"" + escapeShellArg(proj.path) + "\" && rustc -vV");
+            }
+
+            std::string key = hashString(versionByToolchain[toolchain] + "\n" + (rustflags ? rustflags : ""));
+            proj.cargoTargetDir = base + "/" + key;
+            targetDirLocks[proj.cargoTargetDir];
+
+            if (!fs::exists(proj.cargoTargetDir)) {
+                std::error_code ec;
+                fs::create_directories(proj.cargoTargetDir, ec);
+                std::ofstream(proj.cargoTargetDir + "/.focal-run-toolchain") << versionByToolchain[toolchain];
+            }
+        }
+
+        separateBinaryCollisions();
+
+        if (verboseMode) {
+            for (const auto& proj : projects) {
+                if (proj.cargoTargetDir.empty()) continue;
+                std::cout << colorize("  [SHARED]", Color::CYAN) << " " << proj.name
+                         << " -> " << proj.cargoTargetDir << std::endl;
+            }
+        }
+    }
+
+    // Binary names a crate produces: [[bin]] targets, src/main.rs as the package
+    // name, and src/bin/<name>.rs or src/bin/<name>/main.rs
+    std::set<std::string> cargoBinaries(const ProjectInfo& proj) {
+        std::set<std::string> binaries;
+        std::error_code ec;
+        if (!proj.packageName.empty() && fs::exists(proj.path + "/src/main.rs", ec)) binaries.insert(proj.packageName);
+        for (const auto& entry : fs::directory_iterator(proj.path + "/src/bin", ec)) {
+            if (entry.path().extension() == ".rs") binaries.insert(entry.path().stem().string());
+            else if (fs::exists(entry.path() / "main.rs", ec)) binaries.insert(entry.path().filename().string());
+        }
+
+        std::ifstream manifest(proj.path + "/Cargo.toml");
+        std::string line, section;
+        while (std::getline(manifest, line)) {
+            line.erase(0, line.find_first_not_of(" \t"));
+            if (line.rfind("[", 0) == 0) {
+                section = line.substr(0, line.rfind(']') + 1);
+                continue;
+            }
+            if (section != "[[bin]]" || line.compare(0, 4, "name") != 0) continue;
+            size_t open = line.find('"'), close = line.rfind('"');
+            if (open != std::string::npos && close > open) binaries.insert(line.substr(open + 1, close - open - 1));
+        }
+        return binaries;
+    }
+
+    // Crates sharing a target dir put their binaries side by side in
+    // <target>/<profile>/. Crates (or whole workspaces) reusing a binary name
+    // already taken in their dir get a target dir of their own
+    void separateBinaryCollisions() {
+        std::unordered_map<std::string, ProjectInfo*> byPath;
+        for (auto& proj : projects) {
+            if (proj.buildSystem == BuildSystem::Rust) byPath[normalizePath(proj.path)] = &proj;
+        }
+        // A workspace member's binaries belong to the cargo invocation of its root
+        auto unitOf = [&](const ProjectInfo& proj) {
+            return !proj.workspaceRoot.empty() && byPath.count(proj.workspaceRoot) ? proj.workspaceRoot
+                                                                                    : normalizePath(proj.path);
+        };
+
+        std::map<std::string, std::set<std::string>> binariesOf;
+        std::vector<std::string> units;
+        for (const auto& proj : projects) {
+            if (proj.cargoTargetDir.empty()) continue;
+            std::string unit = unitOf(proj);
+            if (!binariesOf.count(unit)) units.push_back(unit);
+            std::set<std::string> binaries = cargoBinaries(proj);
+            binariesOf[unit].insert(binaries.begin(), binaries.end());
+        }
+
+        std::map<std::string, std::map<std::string, std::string>> ownerOf;  // dir -> binary -> unit
+        for (const auto& unit : units) {
+            std::string dir = byPath[unit]->cargoTargetDir;
+            std::string clash;
+            for (const auto& binary : binariesOf[unit]) {
+                auto owner = ownerOf[dir].find(binary);
+                if (owner != ownerOf[dir].end()) {
+                    clash = binary + "' with " + byPath[owner->second]->name;
+                    break;
+                }
+            }
+            if (clash.empty()) {
+                for (const auto& binary : binariesOf[unit]) ownerOf[dir][binary] = unit;
+                continue;
+            }
+
+            std::string own = dir + "-" + hashString(unit);
+            std::cerr << colorize("  [WARN]", Color::YELLOW) << " " << byPath[unit]->name << " shares binary name '"
+                     << clash << ", using its own target dir" << std::endl;
+            for (auto& proj : projects) {
+                if (!proj.cargoTargetDir.empty() && unitOf(proj) == unit) proj.cargoTargetDir = own;
+            }
+            targetDirLocks[own];
+            std::error_code ec;
+            fs::create_directories(own, ec);
+            fs::copy_file(dir + "/.focal-run-toolchain", own + "/.focal-run-toolchain", fs::copy_options::skip_existing, ec);
+        }
+    }
+
+    // Serialize builds sharing a target dir instead of piling up on cargo's file lock
+    std::unique_lock<std::mutex> lockTargetDir(const ProjectInfo& proj) {
+        if (proj.cargoTargetDir.empty()) return std::unique_lock<std::mutex>();
+        std::unique_lock<std::mutex> lock(targetDirLocks[proj.cargoTargetDir], std::try_to_lock);
+        if (!lock.owns_lock()) {
+            if (verboseMode) {
+                std::lock_guard<std::mutex> outputLock(outputMutex);
+                std::cout << colorize("  [WAIT]", Color::YELLOW) << " " << proj.name
+                         << ": shared target dir in use" << std::endl;
+            }
+            lock.lock();
+        }
+        return lock;
+    }
+
+    // Cargo has two profiles: Debug builds dev, every other configuration --release
+    std::string cargoProfileFlag(const ProjectInfo& proj) {
+        if (cargoCommand == "build" || cargoCommand == "test" ||
+            cargoCommand == "bench" || cargoCommand == "check") {
+            if (proj.buildType != "Debug") {
+                return " --release";
+            }
+        }
+        return "";
+    }
+
+    // Package arguments selecting a workspace root's selected members
+    std::string workspaceSelection(const ProjectInfo& root, const std::vector<ProjectInfo*>& members) {
+        if (members.size() == root.workspaceMembers.size()) return " --workspace";
+        std::string selection;
+        if (!root.packageName.empty()) selection += " -p " + root.packageName;
+        for (auto* member : members) {
+            selection += " -p " + (member->packageName.empty() ? member->name : member->packageName);
+        }
+        return selection;
+    }
+
+    // Build the selected members of a Cargo workspace with one cargo invocation
+    bool buildRustWorkspace(ProjectInfo& root, const std::vector<ProjectInfo*>& members) {
+        std::unique_lock<std::mutex> targetLock = lockTargetDir(root);
+        std::unique_lock<std::mutex> lock(outputMutex);
+
+        std::string cargoPrefix = cargoInvocation(root);
+        auto packageOf = [](const ProjectInfo& proj) {
+            return proj.packageName.empty() ? proj.name : proj.packageName;
+        };
+
+        if (cleanMode) {
+            std::string cleanCmd = cargoPrefix + "clean";
+            if (sharedTargetMode && !root.cargoTargetDir.empty()) {
+                if (!root.packageName.empty()) cleanCmd += " -p " + root.packageName;
+                for (auto* member : members) cleanCmd += " -p " + packageOf(*member);
+                if (buildType == "Release") cleanCmd += " --release";
+            }
+            if (verboseMode) {
+                std::cout << colorize("  [CLEAN]", Color::YELLOW) << " " << cleanCmd << std::endl;
+            }
+            bool cleaned = runBuildCommand(root, cleanCmd, lock) == 0;
+            for (auto* member : members) member->success = cleaned;
+            if (!cleaned) {
+                std::cerr << colorize("  [FAILED]", Color::RED) << " Clean failed!" << std::endl;
+            }
+            return cleaned;
+        }
+
+        std::string selection = workspaceSelection(root, members);
+
+        std::string buildCmd = cargoPrefix + cargoCommand + selection + cargoProfileFlag(root);
+        if (verboseMode) {
+            std::cout << colorize("  [WORKSPACE]", Color::CYAN) << " " << root.name << ": "
+                     << members.size() << " member crates, shared target dir" << std::endl;
+            std::cout << colorize("  [CARGO]", Color::GREEN) << " " << buildCmd << std::endl;
+        }
+
+        auto startTime = std::chrono::high_resolution_clock::now();
+        int buildResult = runBuildCommand(root, buildCmd, lock);
+        auto endTime = std::chrono::high_resolution_clock::now();
+        root.stats.buildTime = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
+        root.stats.totalTime = root.stats.buildTime;
+
+        if (verboseMode) {
+            std::cout << colorize("  [TIME]", Color::BLUE)
+                     << " Build: " << root.stats.buildTime.count() << "ms" << std::endl;
+        }
+
+        if (buildResult == 0) {
+            for (auto* member : members) member->success = true;
+            return true;
+        }
+
+        // Attribute the failure: each package alone, reusing the now-warm target dir
+        std::cerr << colorize("  [FAILED]", Color::RED) << " Workspace build failed, checking "
+                 << members.size() << " members individually" << std::endl;
+
+        bool allMembersOk = true;
+        for (auto* member : members) {
+            std::string memberCmd = cargoPrefix + cargoCommand + " -p " + packageOf(*member) + cargoProfileFlag(*member);
+            startTime = std::chrono::high_resolution_clock::now();
+            member->success = runBuildCommand(*member, memberCmd, lock) == 0;
+            endTime = std::chrono::high_resolution_clock::now();
+            member->stats.buildTime = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
+            member->stats.totalTime = member->stats.buildTime;
+            if (!member->success) {
+                std::cerr << colorize("  [FAILED]", Color::RED) << " " << member->name << std::endl;
+                allMembersOk = false;
+            }
+        }
+
+        if (root.packageName.empty()) {
+            return allMembersOk;
+        }
+        std::string rootCmd = cargoPrefix + cargoCommand + " -p " + root.packageName + cargoProfileFlag(root);
+        return runBuildCommand(root, rootCmd, lock) == 0;
+    }
+
+    // With --build-root, Makefiles get their output dirs as variables:
+    // BUILD_DIR, RELEASE_DIR and DEBUG_DIR
+    std::string makeDirVariables(const ProjectInfo& proj) {
+        if (buildRoot.empty()) return "";
+        std::string dir = escapeShellArg(buildRootDir(proj));
+        return " BUILD_DIR=\"" + dir + "\" RELEASE_DIR=\"" + dir + "/release\" DEBUG_DIR=\"" + dir + "/debug\"";
+    }
+
+    bool buildMakefileProject(ProjectInfo& proj) {
+        std::unique_lock<std::mutex> lock(outputMutex);
+
+        if (cleanMode) {
+            std::string escapedPath = escapeShellArg(proj.path);
+            std::string cleanCmd = "cd \"" + escapedPath + "\" && make clean" + makeDirVariables(proj);
+            
+            if (verboseMode) {
+                std::cout << colorize("  [CLEAN]", Color::YELLOW) << " " << cleanCmd << std::endl;
+            }
+
+            auto startTime = std::chrono::high_resolution_clock::now();
+            int cleanResult = runBuildCommand(proj, cleanCmd, lock);
+            auto endTime = std::chrono::high_resolution_clock::now();
+            auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
+
+            if (verboseMode) {
+                std::cout << colorize("  [TIME]", Color::BLUE) 
+                         << " Clean: " << duration.count() << "ms" << std::endl;
+            }
+
+            std::vector<std::string> dirsToClean = {proj.path + "/release", proj.path + "/debug"};
+            if (!buildRoot.empty()) dirsToClean.push_back(buildRootDir(proj));
+            for (const auto& dir : dirsToClean) {
+                if (fs::exists(dir)) {
+                    try {
+                        fs::remove_all(dir);
+                        std::cout << colorize("  [CLEAN]", Color::YELLOW) 
+                                 << " Cleaned: " << dir << std::endl;
+                    } catch (const std::exception& e) {
+                        std::cerr << colorize("  [ERROR]", Color::RED) 
+                                 << " Cleaning " << dir << ": " << e.what() << std::endl;
+                    }
+                }
+            }
+
+            return (cleanResult == 0);
+        }
+
+        // Create directories
+        std::string outputBase = buildRoot.empty() ? proj.path : buildRootDir(proj);
+        std::vector<std::string> dirsToCreate = {outputBase + "/release", outputBase + "/debug"};
+        for (const auto& dir : dirsToCreate) {
+            if (!fs::exists(dir)) {
+                try {
+                    fs::create_directories(dir);
+                    if (verboseMode) {
+                        std::cout << colorize("  [CREATE]", Color::GREEN) 
+                                 << " Directory: " << dir << std::endl;
+                    }
+                } catch (const std::exception& e) {
+                    std::cerr << colorize("  [ERROR]", Color::RED) 
+                             << " Creating " << dir << ": " << e.what() << std::endl;
+                }
+            }
+        }
+
+        // Build
+        std::string escapedPath = escapeShellArg(proj.path);
+        std::string buildCmd = "cd \"" + escapedPath + "\" && make" + makeDirVariables(proj);
+
+        if (verboseMode) {
+            std::cout << colorize("  [MAKE]", Color::GREEN) << " " << buildCmd << std::endl;
+        }
+
+        auto startTime = std::chrono::high_resolution_clock::now();
+        int buildResult = runBuildCommand(proj, buildCmd, lock);
+        auto endTime = std::chrono::high_resolution_clock::now();
+        proj.stats.buildTime = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
+        proj.stats.totalTime = proj.stats.buildTime;
+
+        if (verboseMode) {
+            std::cout << colorize("  [TIME]", Color::BLUE) 
+                     << " Build: " << proj.stats.buildTime.count() << "ms" << std::endl;
+        }
+
+        if (buildResult != 0) {
+            std::cerr << colorize("  [FAILED]", Color::RED) << " Build failed!" << std::endl;
+            return false;
+        }
+
+        return true;
+    }
+
+    // Test stage for a built project: one unit per CTest test or cargo test
+    // binary. Cargo test binaries are compiled here (cargo test --no-run).
+    // A unit's key covers its binary's content, its command line, any files
+    // named on it and the CTest properties (environment, working directory,
+    // REQUIRED_FILES); undeclared data files are not tracked.
+    std::vector<TestUnit> discoverTests(size_t index, const std::vector<ProjectInfo*>* members) {
+        ProjectInfo& proj = projects[index];
+        std::vector<TestUnit> units;
+        auto fileInput = [](const std::string& path) {
+            std::error_code ec;
+            return fs::is_regular_file(path, ec) ? " " + hashFile(path) : std::string();
+        };
+
+        if (proj.buildSystem == BuildSystem::Rust) {
+            std::string cmd = cargoInvocation(proj) + "test --no-run --message-format=json" +
+                              (members ? workspaceSelection(proj, *members) : "") + cargoProfileFlag(proj);
+            std::vector<std::string> messages;
+            std::deque<std::string> tail;
+            int slot = currentSlot;
+            ResourceUsage usage;
+            int result = runCommand(cmd, &usage, [&](const std::string& line) {
+                if (!line.empty() && line[0] == '{') {
+                    messages.push_back(line);
+                    return;
+                }
+                publishLine(slot, line);
+                tail.push_back(line);
+                if (tail.size() > 30) tail.pop_front();
+            });
+            proj.stats.usage.add(usage);
+
+            if (result != 0) {
+                TestUnit unit;
+                unit.project = index;
+                unit.name = "cargo test --no-run";
+                unit.tail = tail;
+                units.push_back(unit);
+                return units;
+            }
+
+            for (const auto& line : messages) {
+                JsonValue message;
+                if (!parseJson(line, message) || message.str("reason") != "compiler-artifact") continue;
+                const JsonValue* profile = message.find("profile");
+                const JsonValue* isTest = profile ? profile->find("test") : nullptr;
+                std::string executable = message.str("executable");
+                if (!isTest || isTest->number == 0.0 || executable.empty()) continue;
+
+                const JsonValue* target = message.find("target");
+                const JsonValue* kinds = target ? target->find("kind") : nullptr;
+                std::string kind = kinds && !kinds->items.empty() ? kinds->items[0].text : "test";
+                std::string packageDir = fs::path(message.str("manifest_path")).parent_path().string();
+
+                TestUnit unit;
+                unit.project = index;
+                unit.name = (target ? target->str("name") : fs::path(executable).stem().string()) + " (" + kind + ")";
+                unit.command = "cd \"" + escapeShellArg(packageDir) + "\" && \"" + escapeShellArg(executable) + "\"";
+                unit.key = hashString("cargo\n" + unit.name + "\n" + packageDir + "\n" + hashFile(executable));
+                units.push_back(unit);
+            }
+            return units;
+        }
+
+        std::string buildDir = cmakeBuildDir(proj);
+        if (proj.isMakefileProject || !fs::exists(buildDir + "/CTestTestfile.cmake")) return units;
+
+        JsonValue listing;
+        std::string ctest = "cd \"" + escapeShellArg(buildDir) + "\" && ctest -C " + proj.buildType;
+        if (!parseJson(captureCommand(ctest + " --show-only=json-v1" QUIET_STDERR), listing)) return units;
+        const JsonValue* tests = listing.find("tests");
+        if (!tests) return units;
+
+        for (const auto& test : tests->items) {
+            std::string name = test.str("name");
+            std::string material = "ctest\n" + name + "\n";
+            const JsonValue* command = test.find("command");
+            if (command) {
+                for (const auto& arg : command->items) material += arg.text + fileInput(arg.text) + "\n";
+            }
+
+            bool benchmark = false;
+            const JsonValue* properties = test.find("properties");
+            for (const auto& property : properties ? properties->items : std::vector<JsonValue>()) {
+                std::string propertyName = property.str("name");
+                const JsonValue* value = property.find("value");
+                if (!value) continue;
+                std::vector<std::string> values;
+                if (value->type == JsonValue::Type::Array) {
+                    for (const auto& item : value->items) values.push_back(item.text);
+                } else {
+                    values.push_back(value->type == JsonValue::Type::String ? value->text : std::to_string(value->number));
+                }
+                // Benchmarks are left to --bench
+                if (propertyName == "LABELS" && std::find(values.begin(), values.end(), benchLabel) != values.end()) {
+                    benchmark = true;
+                }
+                for (const auto& item : values) {
+                    material += propertyName + "=" + item;
+                    if (propertyName == "REQUIRED_FILES") material += fileInput(item);
+                    material += "\n";
+                }
+            }
+            if (benchmark) continue;
+
+            std::string pattern;
+            for (char c : name) {
+                if (std::string("\\^$.|?*+()[]{}").find(c) != std::string::npos) pattern += '\\';
+                pattern += c;
+            }
+
+            TestUnit unit;
+            unit.project = index;
+            unit.name = name;
+            unit.command = ctest + " -R \"^" + escapeShellArg(pattern) + "$\" --output-on-failure";
+            unit.key = hashString(material);
+            units.push_back(unit);
+        }
+        return units;
+    }
+
+    // Run one test unit, keeping the tail of its output for the failure report
+    void runTestUnit(TestUnit& unit) {
+        int slot = currentSlot;
+        ResourceUsage usage;
+        auto startTime = std::chrono::high_resolution_clock::now();
+        int result = runCommand(unit.command, &usage, [this, &unit, slot](const std::string& line) {
+            publishLine(slot, line);
+            unit.tail.push_back(line);
+            if (unit.tail.size() > 30) unit.tail.pop_front();
+            if (verboseMode) {
+                std::lock_guard<std::mutex> outputLock(outputMutex);
+                std::cout << line << std::endl;
+            }
+        });
+        auto endTime = std::chrono::high_resolution_clock::now();
+        unit.duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
+        unit.success = result == 0;
+    }
+
+    // Test results shown under a project in the build report
+    void printTestSummary(const ProjectInfo& proj) {
+        const BuildStats& stats = proj.stats;
+        if (stats.testsPassed + stats.testsCached + stats.testsFailed == 0) return;
+        std::cout << "    Tests: " << stats.testsPassed + stats.testsCached << " passed";
+        if (stats.testsCached > 0) std::cout << " (" << stats.testsCached << " cached)";
+        if (stats.testsFailed > 0) std::cout << ", " << colorize(std::to_string(stats.testsFailed) + " failed", Color::RED);
+        std::cout << std::endl;
+    }
+
+    static std::string lockDir() {
+        return userCacheDir() + "/locks";
+    }
+
+    static long processId() {
+#ifdef _WIN32
+        return (long)GetCurrentProcessId();
+#else
+        return (long)getpid();
+#endif
+    }
+
+    std::string projectLockPath(const ProjectInfo& proj) {
+        std::string tree = proj.buildSystem != BuildSystem::Rust && !proj.isMakefileProject ? cmakeBuildDir(proj) : proj.path;
+        return lockDir() + "/" + hashString(normalizePath(tree) + configSuffix(proj)) + ".lock";
+    }
+
+    // Every lock a build of the project could hold: --gc runs before --configs
+    // is expanded, so the configurations come from the per-config trees under
+    // build/, the multi-config tree's CMAKE_CONFIGURATION_TYPES, --configs and
+    // the cache keys earlier builds left behind
+    std::vector<std::string> treeLockPaths(const ProjectInfo& proj) {
+        std::set<std::string> configs = {""};
+        configs.insert(buildConfigs.begin(), buildConfigs.end());
+        std::string prefix = proj.path + "@";
+        for (const auto& entry : configCache) {
+            size_t end = entry.first.rfind('_');
+            if (entry.first.compare(0, prefix.size(), prefix) == 0 && end != std::string::npos && end > prefix.size()) {
+                configs.insert(entry.first.substr(prefix.size(), end - prefix.size()));
+            }
+        }
+
+        bool cmake = proj.buildSystem != BuildSystem::Rust && !proj.isMakefileProject;
+        std::string base = buildRoot.empty() ? proj.path + "/build" : buildRootDir(proj);
+        std::error_code ec;
+        if (cmake) {
+            for (const auto& entry : fs::directory_iterator(base, ec)) {
+                if (!fs::exists(entry.path() / "CMakeCache.txt", ec)) continue;
+                std::string name = entry.path().filename().string();
+                if (name == "time-report") continue;
+                if (name != "multi") {
+                    configs.insert(name);
+                    continue;
+                }
+                std::ifstream cache(entry.path() / "CMakeCache.txt");
+                std::string line;
+                while (std::getline(cache, line)) {
+                    if (line.rfind("CMAKE_CONFIGURATION_TYPES:", 0) != 0) continue;
+                    for (const auto& config : splitList(line.substr(line.find('=') + 1), ';')) configs.insert(config);
+                }
+            }
+        }
+
+        std::set<std::string> paths;
+        ProjectInfo copy = proj;
+        for (const auto& config : configs) {
+            copy.config = config;
+            if (!cmake) {
+                paths.insert(projectLockPath(copy));
+                continue;
+            }
+            std::vector<std::string> trees = {config.empty() ? base : base + "/" + config, base + "/multi"};
+            if (config.empty()) trees.push_back(base + "/time-report");
+            for (const auto& tree : trees) {
+                paths.insert(lockDir() + "/" + hashString(normalizePath(tree) + configSuffix(copy)) + ".lock");
+            }
+        }
+        return std::vector<std::string>(paths.begin(), paths.end());
+    }
+
+    // Serialize each build stage of a project across focal-run processes: one
+    // lock per build tree (per configuration with --configs). When this run had
+    // to wait and the holder left "done" for the same inputs, its result is
+    // reused and true is returned; otherwise the stage runs as usual
+    bool lockProjectStage(ProjectInfo& proj, FileLock& lock, bool firstStage) {
+        std::string path = projectLockPath(proj);
+        std::error_code ec;
+        fs::create_directories(lockDir(), ec);
+
+        bool waited = false;
+        if (!lock.acquire(path, false)) {
+            std::string holder;
+            std::ifstream(path) >> holder >> holder;
+            publishLine(currentSlot, "waiting for another focal-run (pid " + holder + ")");
+            {
+                std::lock_guard<std::mutex> outputLock(outputMutex);
+                std::cout << colorize("  [WAIT]", Color::YELLOW) << " " << proj.name
+                         << ": being built by another focal-run (pid " << holder << ")" << std::endl;
+            }
+            lock.acquire(path, true);
+            waited = true;
+        }
+        std::string previous = lock.read();
+        lock.write("pid " + std::to_string(processId()) + "\n");
+
+        if (!waited || !firstStage || cleanMode || rebuildMode || proj.inputSig.empty()) return false;
+        if (previous != "done " + projectKey(proj) + " " + proj.inputSig + "\n" || !hasBuildOutput(proj)) return false;
+        proj.reusedBuild = true;
+        std::lock_guard<std::mutex> outputLock(outputMutex);
+        useCachedGenerator(proj);
+        std::cout << colorize("  [REUSED]", Color::GREEN) << " " << proj.name
+                 << ": built meanwhile by another focal-run" << std::endl;
+        return true;
+    }
+
+    // Leave "done" in the project's lock once its tests passed, unless another
+    // focal-run has started on the tree since; the marker only saves it a build
+    void markProjectDone(const ProjectInfo& proj) {
+        FileLock lock;
+        if (lock.acquire(projectLockPath(proj), false)) {
+            lock.write("done " + projectKey(proj) + " " + proj.inputSig + "\n");
+        }
+    }
+
+    // Local builds run their tests in this run (remote ones on the worker; Ninja
+    // graph projects are built after the scheduler, untested); such a build only counts once they pass
+    bool testsFollowBuild(const ProjectInfo& proj) {
+        return testMode && !cleanMode && ninjaGraphPrefixes.find(proj.path) == ninjaGraphPrefixes.end();
+    }
+
+    // --global-jobs: one of N token files shared by every focal-run on the host,
+    // held while a stage or test runs
+    std::unique_ptr<FileLock> acquireJobToken() {
+        if (globalJobs == 0) return nullptr;
+        std::error_code ec;
+        fs::create_directories(lockDir(), ec);
+        auto token = std::make_unique<FileLock>();
+        bool announced = false;
+        while (true) {
+            for (size_t i = 0; i < globalJobs; ++i) {
+                if (token->acquire(lockDir() + "/job-token-" + std::to_string(i), false)) return token;
+            }
+            if (!announced) {
+                publishLine(currentSlot, "waiting for a --global-jobs token");
+                announced = true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+    }
+
+    // Generator for the report of a project that was not built; caller holds outputMutex
+    void useCachedGenerator(ProjectInfo& proj) {
+        if (!proj.detectedGenerator.empty()) return;
+        auto generator = configCache.find(proj.path + "_generator");
+        if (generator != configCache.end()) proj.detectedGenerator = generator->second;
+    }
+
+    // Output hash of a dependency as of this run: freshly hashed after a build, or
+    // the recorded one if the job was itself cut off; "" when unknown
+    std::string currentOutputHash(const ProjectInfo& proj) {
+        if (!proj.outputHash.empty()) return proj.outputHash;
+        if (!proj.upToDate) return "";
+        auto recorded = configCache.find(projectKey(proj) + "_outputHash");
+        return recorded == configCache.end() ? "" : recorded->second;
+    }
+
+    // The dependency outputs a job was built against
+    std::string dependencyOutputs(size_t index, std::unordered_map<size_t, std::unordered_set<size_t>>& jobDeps) {
+        std::vector<std::string> entries;
+        for (size_t dep : jobDeps[index]) {
+            std::string hash = currentOutputHash(projects[dep]);
+            if (hash.empty()) return "";
+            entries.push_back(projectKey(projects[dep]) + " " + hash);
+        }
+        std::sort(entries.begin(), entries.end());
+        std::string listing;
+        for (const auto& entry : entries) listing += entry + "\n";
+        return hashString(listing);
+    }
+
+    // After a successful build, under outputMutex: the job's output hash and the
+    // dependency outputs it saw, compared on the next run by dependencyCutoff
+    void recordOutputs(size_t index, std::unordered_map<size_t, std::unordered_set<size_t>>& jobDeps) {
+        const ProjectInfo& proj = projects[index];
+        std::string key = projectKey(proj);
+        if (!proj.outputHash.empty()) configCache[key + "_outputHash"] = proj.outputHash;
+        if (jobDeps[index].empty() || proj.upToDate) return;
+        std::string seen = dependencyOutputs(index, jobDeps);
+        if (seen.empty()) configCache.erase(key + "_depOutputs");
+        else configCache[key + "_depOutputs"] = seen;
+    }
+
+    // Early cutoff: a job whose dependencies were rebuilt into byte-identical
+    // outputs, and whose own inputs and outputs are as its last successful build
+    // left them, is marked up to date instead of being queued
+    bool dependencyCutoff(size_t index, std::unordered_map<size_t, std::unordered_set<size_t>>& jobDeps,
+                          std::unordered_map<size_t, std::vector<ProjectInfo*>>& workspaceMembers) {
+        ProjectInfo& proj = projects[index];
+        if (jobDeps[index].empty() || rebuildMode || cleanMode || timeReportMode ||
+            ninjaGraphPrefixes.count(proj.path) || !hasBuildOutput(proj)) {
+            return false;
+        }
+
+        std::vector<ProjectInfo*> parts = {&proj};
+        auto members = workspaceMembers.find(index);
+        if (members != workspaceMembers.end()) parts.insert(parts.end(), members->second.begin(), members->second.end());
+        std::vector<std::string> signatures;
+        for (ProjectInfo* part : parts) signatures.push_back(inputSignature(*part));
+
+        std::lock_guard<std::mutex> lock(outputMutex);
+        auto seen = configCache.find(projectKey(proj) + "_depOutputs");
+        if (seen == configCache.end() || seen->second != dependencyOutputs(index, jobDeps)) return false;
+        for (size_t i = 0; i < parts.size(); ++i) {
+            auto recorded = configCache.find(projectKey(*parts[i]) + "_inputSig");
+            if (recorded == configCache.end() || recorded->second != signatures[i]) return false;
+        }
+
+        for (size_t i = 0; i < parts.size(); ++i) {
+            parts[i]->upToDate = true;
+            parts[i]->success = true;
+            parts[i]->inputSig = signatures[i];
+            useCachedGenerator(*parts[i]);
+        }
+        std::cout << colorize("  [UP-TO-DATE]", Color::GREEN) << " " << proj.name
+                 << ": dependency outputs unchanged, not rebuilt" << std::endl;
+        return true;
+    }
+
+    // Whether the directories a build writes still exist
+    bool hasBuildOutput(const ProjectInfo& proj) {
+        if (!buildRoot.empty()) return fs::exists(buildRootDir(proj));
+        for (const auto& output : declaredOutputs(proj)) {
+            if (fs::exists(proj.path + "/" + output)) return true;
+        }
+        return false;
+    }
+
+    // Scheduler jobs: every project except workspace members built by their
+    // root's cargo invocation; a job is released once every job in jobDeps succeeded
+    void planJobs(std::vector<size_t>& jobs, std::unordered_map<size_t, std::vector<ProjectInfo*>>& workspaceMembers,
+                  std::unordered_map<size_t, std::unordered_set<size_t>>& jobDeps) {
+        // Member crates of a selected workspace are built by the root's cargo invocation
+        std::unordered_map<std::string, size_t> workspaceRoots;
+        for (size_t i = 0; i < projects.size(); ++i) {
+            if (projects[i].buildSystem == BuildSystem::Rust && !projects[i].workspaceMembers.empty()) {
+                workspaceRoots[normalizePath(projects[i].path) + configSuffix(projects[i])] = i;
+            }
+        }
+
+        for (size_t i = 0; i < projects.size(); ++i) {
+            auto root = workspaceRoots.find(projects[i].workspaceRoot + configSuffix(projects[i]));
+            if (cargoCommand != "run" && root != workspaceRoots.end()) {
+                projects[i].cargoTargetDir = projects[root->second].cargoTargetDir;
+                workspaceMembers[root->second].push_back(&projects[i]);
+            } else {
+                jobs.push_back(i);
+            }
+        }
+
+        if (dependencyGraph.empty()) analyzeDependencies();
+        std::unordered_map<std::string, size_t> jobOfPath;
+        for (size_t index : jobs) {
+            std::string suffix = configSuffix(projects[index]);
+            jobOfPath[normalizePath(projects[index].path) + suffix] = index;
+            auto members = workspaceMembers.find(index);
+            if (members == workspaceMembers.end()) continue;
+            for (ProjectInfo* member : members->second) jobOfPath[normalizePath(member->path) + suffix] = index;
+        }
+
+        // With --configs a project depends on the same configuration of its
+        // dependencies, or on the single build of a Makefile project
+        for (const auto& entry : jobOfPath) {
+            std::string suffix = configSuffix(projects[entry.second]);
+            auto deps = dependencyGraph.find(entry.first.substr(0, entry.first.size() - suffix.size()));
+            if (deps == dependencyGraph.end()) continue;
+            for (const auto& dep : deps->second) {
+                auto depJob = jobOfPath.find(dep + suffix);
+                if (depJob == jobOfPath.end()) depJob = jobOfPath.find(dep);
+                if (depJob != jobOfPath.end() && depJob->second != entry.second) {
+                    jobDeps[entry.second].insert(depJob->second);
+                }
+            }
+        }
+    }
+
+    void buildAllProjects() {
+        prepareSharedTargets();
+
+        std::vector<size_t> jobs;
+        std::unordered_map<size_t, std::vector<ProjectInfo*>> workspaceMembers;
+        std::unordered_map<size_t, std::unordered_set<size_t>> jobDeps;
+        planJobs(jobs, workspaceMembers, jobDeps);
+        for (const auto& entry : jobDeps) {
+            for (size_t dep : entry.second) projects[dep].hasDependents = true;
+        }
+        prepareNinjaGraph();
+
+        // Recorded peak tree memory per job, reserved against the memory budget while it runs,
+        // and the last build time, shown as the estimate on the dashboard
+        std::vector<long> expectedRssKb(projects.size(), 0);
+        std::vector<long> expectedMs(projects.size(), 0);
+        for (size_t index : jobs) {
+            auto cached = configCache.find(projectKey(projects[index]) + "_peakRssKb");
+            if (cached != configCache.end()) expectedRssKb[index] = std::atol(cached->second.c_str());
+            cached = configCache.find(projectKey(projects[index]) + "_buildMs");
+            if (cached != configCache.end()) expectedMs[index] = std::atol(cached->second.c_str());
+        }
+
+        SystemLoad load;
+        long memoryBudgetKb = 0;
+        std::atomic<bool> controllerStop{false};
+        std::thread controller;
+        activeSlots = maxConcurrentBuilds;
+        if (adaptiveMode && readSystemLoad(load)) {
+            memoryBudgetKb = load.memAvailableKb * 9 / 10;
+            controller = std::thread([this, &controllerStop]() { runConcurrencyController(controllerStop); });
+            if (verboseMode) {
+                std::cout << colorize("  [ADAPT]", Color::CYAN) << " " << activeSlots << " slots (max "
+                         << adaptiveCeiling << "), memory budget " << memoryBudgetKb / 1024 << " MB" << std::endl;
+            }
+        }
+
+        // Two pipeline stages with separate slot pools: CMake configure steps
+        // (mostly single-threaded probing) run up to --configure-jobs at once and
+        // feed the build queue; build steps use the adaptive slot count and must
+        // fit the memory budget, except that one build always runs
+        std::deque<size_t> configureQueue;
+        std::deque<size_t> buildQueue;
+
+        // Test stage (--test): discovery and then each test unit take build
+        // slots left over by builds; units start longest-recorded first
+        std::deque<size_t> discoverQueue;
+        std::deque<size_t> testQueue;
+        std::deque<TestUnit> testUnits;
+        std::unordered_map<size_t, std::vector<TestUnit>> discovered;
+
+        std::vector<size_t> waiting = jobs;
+        std::unordered_map<size_t, bool> jobResults;
+
+        // Remote workers take whole projects that have not started locally. Their
+        // reader threads stream LOG lines and report DONE through the same queue
+        std::vector<std::unique_ptr<RemoteWorker>> remotes = connectWorkers();
+        size_t remoteSequence = 0;
+        std::unordered_map<size_t, std::string> remoteOf;
+        std::unordered_set<size_t> refusedRemote;   // A worker answered BUSY: build these locally
+
+        // Status slots for the dashboard: every local and remote build that can run at once
+        slotCount = adaptiveCeiling + configureJobs;
+        for (const auto& remote : remotes) slotCount += remote->slots;
+        slots.reset(new SlotStatus[slotCount]);
+        planSlotPlacement(adaptiveCeiling);
+        std::vector<int> jobSlot(projects.size(), -1);
+        auto releaseSlot = [&](size_t index) {
+            if (jobSlot[index] >= 0) slots[jobSlot[index]].project = -1;
+            jobSlot[index] = -1;
+        };
+
+        // Renderer: redraws the dashboard ten times a second on a terminal
+        std::atomic<bool> rendererStop{false};
+        std::thread renderer;
+        std::streambuf* savedOut = std::cout.rdbuf();
+        std::streambuf* savedErr = std::cerr.rdbuf();
+        DashboardBuf outBuf(savedOut, dashboardLines);
+        DashboardBuf errBuf(savedErr, dashboardLines);
+#ifndef _WIN32
+        dashboardActive = showProgress && colorOutput && isatty(STDOUT_FILENO);
+#endif
+        if (dashboardActive) {
+            dashboardDone = 0;
+            dashboardTotal = projects.size();
+            std::cout.rdbuf(&outBuf);
+            std::cerr.rdbuf(&errBuf);
+            long long runStartMs = steadyMillis();
+            renderer = std::thread([this, &rendererStop, &outBuf, runStartMs]() {
+                while (!rendererStop) {
+                    {
+                        std::lock_guard<std::mutex> lock(outputMutex);
+                        drawDashboard(outBuf, runStartMs);
+                    }
+                    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                }
+            });
+        }
+
+        struct StageResult {
+            size_t index;
+            bool configure;
+            bool success;
+            bool remote = false;
+            bool lost = false;
+            bool test = false;
+            size_t unit = SIZE_MAX;  // test unit, or SIZE_MAX for a discovery step
+            bool busy = false;       // Lost because the worker answered BUSY
+        };
+
+        std::unordered_map<size_t, std::thread> workers;
+        std::mutex doneMutex;
+        std::condition_variable doneCv;
+        std::vector<StageResult> finished;
+        size_t runningConfigure = 0;
+        size_t runningBuild = 0;
+        size_t runningRemote = 0;
+        long reservedRssKb = 0;
+        size_t totalProjects = projects.size();
+        size_t completedProjects = 0;
+
+        auto startStage = [&](size_t index, bool configure) {
+            bool firstStage = configure || projects[index].buildSystem == BuildSystem::Rust ||
+                              projects[index].isMakefileProject;
+            std::string phase = configure ? "configure"
+                : projects[index].buildSystem == BuildSystem::Rust ? "cargo"
+                : projects[index].isMakefileProject ? "make" : "build";
+            int slot = jobSlot[index] = claimSlot(index, phase, expectedMs[index]);
+
+            workers[index] = std::thread([this, index, configure, firstStage, phase, slot, &workspaceMembers,
+                                          &doneMutex, &doneCv, &finished]() {
+                currentSlot = slot;
+                int lane = claimLane();
+                if (firstStage) emitEvent(BuildEvent::Type::Started, index, phase);
+                if (firstStage && !(dashboardActive && !verboseMode)) {
+                    std::lock_guard<std::mutex> lock(outputMutex);
+                    if (!verboseMode) {
+                        std::cout << colorize("Building: ", Color::CYAN)
+                                 << projects[index].name << std::endl;
+                    } else {
+                        std::cout << "\n" << colorize("=== Processing: ", Color::BOLD)
+                                 << projects[index].name << " ===" << std::endl;
+                        std::cout << "Path: " << projects[index].path << std::endl;
+                    }
+                }
+
+                bool success;
+                auto members = workspaceMembers.find(index);
+                // Inputs as of the start of the build, recorded for --plan once it succeeds
+                if (firstStage && !cleanMode) {
+                    projects[index].inputSig = inputSignature(projects[index]);
+                    if (members != workspaceMembers.end()) {
+                        for (ProjectInfo* member : members->second) member->inputSig = inputSignature(*member);
+                    }
+                }
+                // The project lock comes first: a token is only held by a stage that can run
+                FileLock buildLock;
+                bool reused = lockProjectStage(projects[index], buildLock, firstStage);
+                std::unique_ptr<FileLock> token = reused ? nullptr : acquireJobToken();
+                if (reused || (firstStage && restoreArtifacts(projects[index]))) {
+                    success = true;
+                    if (members != workspaceMembers.end()) {
+                        for (ProjectInfo* member : members->second) member->success = true;
+                    }
+                } else if (configure) {
+                    success = configureCMakeProject(projects[index]);
+                } else if (members != workspaceMembers.end()) {
+                    success = buildRustWorkspace(projects[index], members->second);
+                } else if (projects[index].buildSystem == BuildSystem::Rust || projects[index].isMakefileProject) {
+                    success = buildProject(projects[index]);
+                } else {
+                    success = compileCMakeProject(projects[index]);
+                }
+
+                // Ninja graph projects are only built, and marked done, after the scheduler
+                if (success && (!configure || !needsBuildStage(projects[index])) &&
+                    ninjaGraphPrefixes.find(projects[index].path) == ninjaGraphPrefixes.end()) {
+                    if (projects[index].hasDependents) projects[index].outputHash = outputHash(projects[index]);
+                    // With tests to run, the store entry and "done" wait until they pass
+                    if (!testsFollowBuild(projects[index])) {
+                        storeArtifacts(projects[index]);
+                        if (!cleanMode) buildLock.write("done " + projectKey(projects[index]) + " " + projects[index].inputSig + "\n");
+                    }
+                }
+
+                releaseLane(lane);
+                std::lock_guard<std::mutex> lock(doneMutex);
+                finished.push_back({index, configure, success});
+                doneCv.notify_one();
+            });
+        };
+
+        auto startDiscovery = [&](size_t index) {
+            int slot = jobSlot[index] = claimSlot(index, "test", 0);
+            workers[index] = std::thread([this, index, slot, &workspaceMembers, &discovered,
+                                          &doneMutex, &doneCv, &finished]() {
+                currentSlot = slot;
+                int lane = claimLane();
+                std::unique_ptr<FileLock> token = acquireJobToken();
+                auto members = workspaceMembers.find(index);
+                std::vector<TestUnit> units =
+                    discoverTests(index, members != workspaceMembers.end() ? &members->second : nullptr);
+                releaseLane(lane);
+                std::lock_guard<std::mutex> lock(doneMutex);
+                discovered[index] = std::move(units);
+                finished.push_back({index, false, true, false, false, true});
+                doneCv.notify_one();
+            });
+        };
+
+        // Per project whose build waits on its tests: the discovery step plus
+        // each queued test unit still to finish
+        std::unordered_map<size_t, size_t> testsLeft;
+        auto awaitTests = [&](size_t index) {
+            projects[index].success = true;
+            testsLeft[index] = 1;
+            discoverQueue.push_back(index);
+        };
+
+        std::unordered_map<size_t, std::thread> testWorkers;
+        auto startTest = [&](size_t unitIndex) {
+            TestUnit& unit = testUnits[unitIndex];
+            int slot = claimSlot(unit.project, "test", unit.expectedMs);
+            testWorkers[unitIndex] = std::thread([this, &unit, unitIndex, slot, &doneMutex, &doneCv, &finished]() {
+                currentSlot = slot;
+                int lane = claimLane();
+                std::unique_ptr<FileLock> token = acquireJobToken();
+                runTestUnit(unit);
+                token.reset();
+                releaseLane(lane);
+                if (slot >= 0) slots[slot].project = -1;
+                std::lock_guard<std::mutex> lock(doneMutex);
+                finished.push_back({unit.project, false, unit.success, false, false, true, unitIndex});
+                doneCv.notify_one();
+            });
+        };
+
+        // Queue a project's discovered tests; unchanged passing tests are cached passes
+        auto queueTests = [&](size_t index) {
+            ProjectInfo& proj = projects[index];
+            std::vector<TestUnit> units;
+            {
+                std::lock_guard<std::mutex> lock(doneMutex);
+                units = std::move(discovered[index]);
+                discovered.erase(index);
+            }
+
+            std::lock_guard<std::mutex> lock(outputMutex);
+            for (auto& unit : units) {
+                std::string timingKey = projectKey(proj) + "_testMs:" + hashString(unit.name);
+                auto timing = configCache.find(timingKey);
+                if (timing != configCache.end()) unit.expectedMs = std::atol(timing->second.c_str());
+
+                if (unit.command.empty()) {
+                    proj.stats.testsFailed++;
+                    std::cerr << colorize("  [FAILED]", Color::RED) << " " << proj.name << ": " << unit.name << std::endl;
+                    for (const auto& text : unit.tail) std::cerr << "    " << text << std::endl;
+                    proj.success = false;
+                    continue;
+                }
+                if (testCacheMode && configCache["test:" + unit.key] == "pass") {
+                    proj.stats.testsCached++;
+                    if (verboseMode) {
+                        std::cout << colorize("  [CACHE]", Color::CYAN) << " " << proj.name << ": "
+                                 << unit.name << " passed (unchanged)" << std::endl;
+                    }
+                    continue;
+                }
+                testUnits.push_back(unit);
+                testQueue.push_back(testUnits.size() - 1);
+                testsLeft[index]++;
+            }
+            std::stable_sort(testQueue.begin(), testQueue.end(), [&](size_t a, size_t b) {
+                return testUnits[a].expectedMs > testUnits[b].expectedMs;
+            });
+        };
+
+        auto finishTest = [&](size_t unitIndex) {
+            TestUnit& unit = testUnits[unitIndex];
+            ProjectInfo& proj = projects[unit.project];
+            std::lock_guard<std::mutex> lock(outputMutex);
+            configCache[projectKey(proj) + "_testMs:" + hashString(unit.name)] = std::to_string(unit.duration.count());
+            if (unit.success) {
+                proj.stats.testsPassed++;
+                configCache["test:" + unit.key] = "pass";
+                if (verboseMode) {
+                    std::cout << colorize("  [TEST]", Color::GREEN) << " " << proj.name << ": " << unit.name
+                             << " passed (" << unit.duration.count() << "ms)" << std::endl;
+                }
+                return;
+            }
+            proj.stats.testsFailed++;
+            proj.success = false;
+            configCache.erase("test:" + unit.key);
+            std::cerr << colorize("  [FAILED]", Color::RED) << " " << proj.name << ": test " << unit.name << std::endl;
+            if (!verboseMode) {
+                for (const auto& text : unit.tail) std::cerr << "    " << text << std::endl;
+            }
+        };
+
+        // Configured Ninja graph projects, finished once buildNinjaGraph built them
+        std::vector<size_t> graphPending;
+
+        auto finishJob = [&](size_t index, bool success) {
+            ProjectInfo& proj = projects[index];
+            proj.success = success;
+            jobResults[index] = success;
+            auto members = workspaceMembers.find(index);
+            {
+                std::lock_guard<std::mutex> lock(outputMutex);
+                recordUsage(proj);
+                if (success && proj.stats.totalTime.count() > 0) {
+                    configCache[projectKey(proj) + "_buildMs"] = std::to_string(proj.stats.totalTime.count());
+                }
+                if (success) {
+                    recordInputs(proj);
+                    recordOutputs(index, jobDeps);
+                }
+                if (members != workspaceMembers.end()) {
+                    for (ProjectInfo* member : members->second) {
+                        recordUsage(*member);
+                        if (success) recordInputs(*member);
+                    }
+                }
+            }
+
+            completedProjects += 1 + (members != workspaceMembers.end() ? members->second.size() : 0);
+            showProgressBar(completedProjects, totalProjects,
+                          proj.name + " " + (proj.success ? "✓" : "✗"));
+            emitEvent(BuildEvent::Type::Finished, index);
+        };
+
+        // A build waiting on its tests is finished once the last one is in: only
+        // then are its inputs recorded, its outputs stored and dependents released
+        auto finishTested = [&](size_t index) {
+            if (--testsLeft[index] > 0) return;
+            testsLeft.erase(index);
+            ProjectInfo& proj = projects[index];
+            if (proj.success) {
+                storeArtifacts(proj);
+                markProjectDone(proj);
+            }
+            finishJob(index, proj.success);
+        };
+
+        auto releaseReady = [&]() {
+            bool changed = true;
+            while (changed) {
+                changed = false;
+                for (auto it = waiting.begin(); it != waiting.end();) {
+                    size_t index = *it;
+                    bool ready = true;
+                    bool depFailed = false;
+                    for (size_t dep : jobDeps[index]) {
+                        auto result = jobResults.find(dep);
+                        if (result == jobResults.end()) ready = false;
+                        else if (!result->second) depFailed = true;
+                    }
+
+                    if (depFailed) {
+                        {
+                            std::lock_guard<std::mutex> lock(outputMutex);
+                            std::cerr << colorize("  [SKIPPED]", Color::YELLOW) << " " << projects[index].name
+                                     << ": a dependency failed" << std::endl;
+                        }
+                        it = waiting.erase(it);
+                        finishJob(index, false);
+                        changed = true;
+                    } else if (ready && dependencyCutoff(index, jobDeps, workspaceMembers)) {
+                        it = waiting.erase(it);
+                        if (testMode) {
+                            awaitTests(index);
+                        } else {
+                            finishJob(index, true);
+                        }
+                        changed = true;
+                    } else if (ready) {
+                        bool configureFirst = projects[index].buildSystem != BuildSystem::Rust &&
+                                              !projects[index].isMakefileProject;
+                        (configureFirst ? configureQueue : buildQueue).push_back(index);
+                        it = waiting.erase(it);
+                    } else {
+                        ++it;
+                    }
+                }
+            }
+
+            // A dependency cycle would stall the run: build what is left in scan order
+            if (!waiting.empty() && configureQueue.empty() && buildQueue.empty() && testsLeft.empty() &&
+                runningConfigure + runningBuild + runningRemote == 0) {
+                std::lock_guard<std::mutex> lock(outputMutex);
+                std::cerr << colorize("  [WARN]", Color::YELLOW)
+                         << " Dependency cycle, ignoring order for " << waiting.size() << " projects" << std::endl;
+                for (size_t index : waiting) {
+                    bool configureFirst = projects[index].buildSystem != BuildSystem::Rust &&
+                                          !projects[index].isMakefileProject;
+                    (configureFirst ? configureQueue : buildQueue).push_back(index);
+                }
+                waiting.clear();
+            }
+        };
+
+#ifndef _WIN32
+        for (auto& remotePtr : remotes) {
+            RemoteWorker* remote = remotePtr.get();
+            remote->reader = std::thread([this, remote, &doneMutex, &doneCv, &finished, &jobSlot]() {
+                std::string buffer, line;
+                std::unordered_map<std::string, std::deque<std::string>> tails;
+                while (readLine(remote->fd, buffer, line)) {
+                    std::stringstream ss(line);
+                    std::string kind, id;
+                    ss >> kind >> id;
+
+                    size_t index;
+                    int slot;
+                    {
+                        std::lock_guard<std::mutex> lock(doneMutex);
+                        auto job = remote->inflight.find(id);
+                        if (job == remote->inflight.end()) continue;
+                        index = job->second;
+                        slot = jobSlot[index];
+                    }
+
+                    if (kind == "LOG") {
+                        std::string text = line.size() > kind.size() + id.size() + 2
+                            ? line.substr(kind.size() + id.size() + 2) : "";
+                        publishLine(slot, text);
+                        if (verboseMode) {
+                            std::lock_guard<std::mutex> lock(outputMutex);
+                            std::cout << colorize("  [" + remote->host + "] ", Color::MAGENTA)
+                                     << projects[index].name << ": " << text << std::endl;
+                        } else {
+                            tails[id].push_back(text);
+                            if (tails[id].size() > 20) tails[id].pop_front();
+                        }
+                    } else if (kind == "DONE") {
+                        int exitCode = 1;
+                        long ms = 0;
+                        ss >> exitCode >> ms;
+                        if (exitCode != 0 && !verboseMode) {
+                            std::lock_guard<std::mutex> lock(outputMutex);
+                            std::cerr << colorize("  [FAILED]", Color::RED) << " " << projects[index].name
+                                     << " on " << remote->host << ":" << std::endl;
+                            for (const auto& text : tails[id]) std::cerr << "    " << text << std::endl;
+                        }
+                        tails.erase(id);
+
+                        std::lock_guard<std::mutex> lock(doneMutex);
+                        projects[index].stats.totalTime = std::chrono::milliseconds(ms);
+                        remote->inflight.erase(id);
+                        finished.push_back({index, false, exitCode == 0, true, false});
+                        doneCv.notify_one();
+                    } else if (kind == "BUSY") {
+                        std::lock_guard<std::mutex> lock(doneMutex);
+                        remote->inflight.erase(id);
+                        finished.push_back({index, false, false, true, true, false, SIZE_MAX, true});
+                        doneCv.notify_one();
+                    }
+                }
+
+                // Connection lost: hand the unfinished builds back to the local queues
+                std::lock_guard<std::mutex> lock(doneMutex);
+                remote->alive = false;
+                for (const auto& job : remote->inflight) finished.push_back({job.second, false, false, true, true});
+                remote->inflight.clear();
+                doneCv.notify_one();
+            });
+        }
+#endif
+
+        auto dispatchRemote = [&]() {
+            for (auto& remote : remotes) {
+                while (remote->busy < remote->slots) {
+                    std::lock_guard<std::mutex> lock(doneMutex);
+                    if (!remote->alive) break;
+
+                    // Whole projects only: not yet configured, not a workspace, not part of the Ninja graph
+                    auto eligible = [&](size_t index) {
+                        return !workspaceMembers.count(index) && !refusedRemote.count(index) &&
+                               ninjaGraphPrefixes.find(projects[index].path) == ninjaGraphPrefixes.end();
+                    };
+                    std::deque<size_t>* queue = nullptr;
+                    std::deque<size_t>::iterator job;
+                    for (auto* candidate : {&configureQueue, &buildQueue}) {
+                        job = std::find_if(candidate->begin(), candidate->end(), [&](size_t index) {
+                            return eligible(index) && (candidate == &configureQueue ||
+                                   projects[index].buildSystem == BuildSystem::Rust || projects[index].isMakefileProject);
+                        });
+                        if (job != candidate->end()) {
+                            queue = candidate;
+                            break;
+                        }
+                    }
+                    if (!queue) return;
+
+                    size_t index = *job;
+                    queue->erase(job);
+                    std::string id = std::to_string(++remoteSequence);
+                    std::string request = "BUILD " + id + "\t" + workerToken + "\t" + mapWorkerPath(projects[index].path) +
+                                          "\t" + workerBuildArgs(projects[index]);
+#ifndef _WIN32
+                    bool sent;
+                    {
+                        std::lock_guard<std::mutex> sendLock(remote->sendMutex);
+                        sent = sendLine(remote->fd, request);
+                    }
+                    if (!sent) {
+                        remote->alive = false;
+                        queue->push_front(index);
+                        break;
+                    }
+#endif
+                    remote->inflight[id] = index;
+                    remote->busy++;
+                    runningRemote++;
+                    remoteOf[index] = remote->address;
+                    jobSlot[index] = claimSlot(index, "remote", expectedMs[index]);
+                    emitEvent(BuildEvent::Type::Started, index, "remote");
+
+                    std::lock_guard<std::mutex> outputLock(outputMutex);
+                    if (projects[index].buildSystem != BuildSystem::Rust && !projects[index].isMakefileProject) {
+                        determineBuildSystem(projects[index]);
+                    }
+                    if (dashboardActive && !verboseMode) continue;
+                    std::cout << colorize("Building: ", Color::CYAN) << projects[index].name
+                             << colorize(" @ " + remote->host, Color::MAGENTA) << std::endl;
+                }
+            }
+        };
+
+        releaseReady();
+        while (!configureQueue.empty() || !buildQueue.empty() || !discoverQueue.empty() || !testQueue.empty() ||
+               runningConfigure + runningBuild + runningRemote > 0) {
+            while (!buildQueue.empty() && runningBuild < activeSlots.load()) {
+                auto fit = std::find_if(buildQueue.begin(), buildQueue.end(), [&](size_t index) {
+                    return memoryBudgetKb == 0 || runningBuild == 0 ||
+                           reservedRssKb + expectedRssKb[index] <= memoryBudgetKb;
+                });
+                if (fit == buildQueue.end()) break;
+
+                size_t index = *fit;
+                buildQueue.erase(fit);
+                runningBuild++;
+                reservedRssKb += expectedRssKb[index];
+                startStage(index, false);
+            }
+
+            while (!discoverQueue.empty() && runningBuild < activeSlots.load()) {
+                runningBuild++;
+                startDiscovery(discoverQueue.front());
+                discoverQueue.pop_front();
+            }
+
+            while (!testQueue.empty() && runningBuild < activeSlots.load()) {
+                runningBuild++;
+                startTest(testQueue.front());
+                testQueue.pop_front();
+            }
+
+            dispatchRemote();
+
+            while (!configureQueue.empty() && runningConfigure < configureJobs) {
+                size_t index = configureQueue.front();
+                configureQueue.pop_front();
+                runningConfigure++;
+                startStage(index, true);
+            }
+
+            std::vector<StageResult> completed;
+            {
+                std::unique_lock<std::mutex> lock(doneMutex);
+                doneCv.wait_for(lock, std::chrono::milliseconds(100), [&finished]() { return !finished.empty(); });
+                completed.swap(finished);
+            }
+
+            for (const auto& result : completed) {
+                if (result.test) {
+                    runningBuild--;
+                    if (result.unit == SIZE_MAX) {
+                        releaseSlot(result.index);
+                        workers[result.index].join();
+                        workers.erase(result.index);
+                        queueTests(result.index);
+                        finishTested(result.index);
+                    } else {
+                        testWorkers[result.unit].join();
+                        testWorkers.erase(result.unit);
+                        finishTest(result.unit);
+                        finishTested(testUnits[result.unit].project);
+                    }
+                    continue;
+                }
+
+                releaseSlot(result.index);
+                if (result.remote) {
+                    runningRemote--;
+                    for (auto& remote : remotes) {
+                        if (remote->address == remoteOf[result.index]) remote->busy--;
+                    }
+                    if (result.lost) {
+                        if (result.busy) refusedRemote.insert(result.index);
+                        std::cerr << colorize("  [WARN]", Color::YELLOW) << (result.busy ? " Busy worker " : " Lost worker ")
+                                 << remoteOf[result.index] << ", building " << projects[result.index].name << " locally" << std::endl;
+                        bool configureFirst = projects[result.index].buildSystem != BuildSystem::Rust &&
+                                              !projects[result.index].isMakefileProject;
+                        (configureFirst ? configureQueue : buildQueue).push_back(result.index);
+                        continue;
+                    }
+                    finishJob(result.index, result.success);
+                    continue;
+                }
+
+                workers[result.index].join();
+                workers.erase(result.index);
+
+                ProjectInfo& proj = projects[result.index];
+                if (result.configure) {
+                    runningConfigure--;
+                    if (result.success && needsBuildStage(proj)) {
+                        buildQueue.push_back(result.index);
+                        continue;
+                    }
+                } else {
+                    runningBuild--;
+                    reservedRssKb -= expectedRssKb[result.index];
+                }
+
+                // Remote builds ran their tests on the worker; Ninja graph projects are not built yet
+                if (result.success && ninjaGraphPrefixes.count(proj.path)) {
+                    proj.success = true;
+                    graphPending.push_back(result.index);
+                } else if (result.success && testsFollowBuild(proj)) {
+                    awaitTests(result.index);
+                } else {
+                    finishJob(result.index, result.success);
+                }
+            }
+
+            if (!completed.empty()) releaseReady();
+        }
+
+#ifndef _WIN32
+        for (auto& remote : remotes) {
+            shutdown(remote->fd, SHUT_RDWR);
+            if (remote->reader.joinable()) remote->reader.join();
+            close(remote->fd);
+        }
+#endif
+
+        if (dashboardActive) {
+            rendererStop = true;
+            renderer.join();
+            std::lock_guard<std::mutex> lock(outputMutex);
+            outBuf.erase();
+            std::cout.rdbuf(savedOut);
+            std::cerr.rdbuf(savedErr);
+            dashboardActive = false;
+            std::cout << colorize("Built " + std::to_string(dashboardDone.load()) + "/" +
+                                  std::to_string(dashboardTotal.load()) + " projects", Color::BOLD) << std::endl;
+        }
+
+        controllerStop = true;
+        if (controller.joinable()) {
+            controller.join();
+        }
+
+        // Configured Ninja graph projects count as built once the graph built them
+        if (!ninjaGraphPrefixes.empty()) {
+            buildNinjaGraph();
+            for (size_t index : graphPending) {
+                if (projects[index].success) markProjectDone(projects[index]);
+                finishJob(index, projects[index].success);
+            }
+        }
+
+        if (artifactCacheMode) {
+            collectArtifactGarbage();
+        }
+
+        if (!verboseMode) {
+            std::cout << std::endl;
+        }
+    }
+
+    // Simulated wall time of the jobs on a number of slots: jobs start in
+    // release order as soon as their dependencies are done, like the scheduler
+    static long simulateMakespan(const std::vector<size_t>& jobs,
+                                 const std::unordered_map<size_t, std::unordered_set<size_t>>& jobDeps,
+                                 const std::unordered_map<size_t, long>& cost, size_t slotCount) {
+        std::unordered_map<size_t, size_t> pending;
+        std::unordered_map<size_t, std::vector<size_t>> dependents;
+        for (size_t index : jobs) {
+            auto deps = jobDeps.find(index);
+            pending[index] = deps == jobDeps.end() ? 0 : deps->second.size();
+            if (deps == jobDeps.end()) continue;
+            for (size_t dep : deps->second) dependents[dep].push_back(index);
+        }
+
+        std::vector<size_t> waiting = jobs;
+        std::deque<size_t> ready;
+        using Running = std::pair<long, size_t>;
+        std::vector<Running> running;
+        long now = 0;
+        size_t done = 0;
+        while (done < jobs.size()) {
+            for (auto it = waiting.begin(); it != waiting.end();) {
+                if (pending[*it] == 0) {
+                    ready.push_back(*it);
+                    it = waiting.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+            // Dependency cycle: the scheduler ignores the order for what is left
+            if (ready.empty() && running.empty()) {
+                ready.insert(ready.end(), waiting.begin(), waiting.end());
+                waiting.clear();
+            }
+            while (!ready.empty() && running.size() < slotCount) {
+                running.push_back({now + cost.at(ready.front()), ready.front()});
+                std::push_heap(running.begin(), running.end(), std::greater<Running>());
+                ready.pop_front();
+            }
+
+            std::pop_heap(running.begin(), running.end(), std::greater<Running>());
+            Running next = running.back();
+            running.pop_back();
+            now = next.first;
+            done++;
+            for (size_t dependent : dependents[next.second]) {
+                if (pending[dependent] > 0) pending[dependent]--;
+            }
+        }
+        return now;
+    }
+
+    // What a build would do without building: whether each job rebuilds and
+    // why, estimates from .focal-run-cache, the critical path and makespans
+    BuildPlan computePlan() {
+        std::vector<size_t> jobs;
+        std::unordered_map<size_t, std::vector<ProjectInfo*>> workspaceMembers;
+        std::unordered_map<size_t, std::unordered_set<size_t>> jobDeps;
+        planJobs(jobs, workspaceMembers, jobDeps);
+
+        auto cachedMs = [this](const ProjectInfo& proj, const std::string& suffix) {
+            auto entry = configCache.find(projectKey(proj) + suffix);
+            return entry == configCache.end() ? -1L : std::atol(entry->second.c_str());
+        };
+
+        // Why each job would rebuild; "" when it is up to date
+        std::unordered_map<size_t, std::string> reason;
+        for (size_t index : jobs) {
+            std::vector<const ProjectInfo*> parts = {&projects[index]};
+            auto members = workspaceMembers.find(index);
+            if (members != workspaceMembers.end()) parts.insert(parts.end(), members->second.begin(), members->second.end());
+
+            std::string why;
+            for (const ProjectInfo* part : parts) {
+                auto recorded = configCache.find(projectKey(*part) + "_inputSig");
+                if (recorded == configCache.end()) why = "never built";
+                else if (recorded->second != inputSignature(*part)) why = "sources changed";
+                if (!why.empty()) break;
+            }
+            if (why.empty() && rebuildMode) why = "--rebuild";
+            if (why.empty() && !hasBuildOutput(projects[index])) why = "no build output";
+            reason[index] = why;
+        }
+
+        // A job rebuilds when any job it depends on does
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (size_t index : jobs) {
+                if (!reason[index].empty()) continue;
+                for (size_t dep : jobDeps[index]) {
+                    if (!reason[dep].empty()) {
+                        reason[index] = "depends on " + projects[dep].name;
+                        changed = true;
+                        break;
+                    }
+                }
+            }
+        }
+
+        // Estimates: the last rebuild or no-op build; unknown rebuilds use the median
+        std::unordered_map<size_t, long> cost;
+        std::vector<long> known;
+        for (size_t index : jobs) {
+            long ms = reason[index].empty() ? cachedMs(projects[index], "_noopMs") : cachedMs(projects[index], "_rebuildMs");
+            if (ms < 0 && !reason[index].empty()) ms = cachedMs(projects[index], "_buildMs");
+            if (ms < 0 && reason[index].empty()) ms = 0;
+            cost[index] = ms;
+            if (ms >= 0 && !reason[index].empty()) known.push_back(ms);
+        }
+        long fallbackMs = 0;
+        if (!known.empty()) {
+            std::nth_element(known.begin(), known.begin() + known.size() / 2, known.end());
+            fallbackMs = known[known.size() / 2];
+        }
+        std::unordered_set<size_t> estimated;
+        for (auto& entry : cost) {
+            if (entry.second < 0) {
+                entry.second = fallbackMs;
+                estimated.insert(entry.first);
+            }
+        }
+
+        BuildPlan plan;
+        for (size_t index : jobs) {
+            PlanEntry entry;
+            entry.project = projects[index].name;
+            entry.path = relativeProjectPath(projects[index]);
+            entry.rebuild = !reason[index].empty();
+            entry.reason = reason[index];
+            entry.estimateMs = cost[index];
+            entry.estimated = estimated.count(index) > 0;
+            for (size_t dep : jobDeps[index]) entry.dependsOn.push_back(projects[dep].name);
+            std::sort(entry.dependsOn.begin(), entry.dependsOn.end());
+            plan.rebuilds += entry.rebuild;
+            plan.workMs += entry.estimateMs;
+            plan.entries.push_back(entry);
+        }
+
+        // Critical path: the most expensive dependency chain
+        std::unordered_map<size_t, long> pathMs;
+        std::unordered_map<size_t, size_t> pathNext;
+        std::vector<size_t> visiting;
+        std::function<long(size_t)> longest = [&](size_t index) -> long {
+            auto known = pathMs.find(index);
+            if (known != pathMs.end()) return known->second;
+            visiting.push_back(index);
+            long best = 0;
+            for (size_t dep : jobDeps[index]) {
+                // A back edge closes a cycle; the path does not follow it
+                auto open = std::find(visiting.begin(), visiting.end(), dep);
+                if (open != visiting.end()) {
+                    if (plan.cycle.empty()) {
+                        for (auto it = open; it != visiting.end(); ++it) plan.cycle.push_back(projects[*it].name);
+                        plan.cycle.push_back(projects[dep].name);
+                    }
+                    continue;
+                }
+                long ms = longest(dep);
+                if (ms > best || !pathNext.count(index)) pathNext[index] = dep;
+                best = std::max(best, ms);
+            }
+            visiting.pop_back();
+            return pathMs[index] = best + cost[index];
+        };
+        size_t tail = jobs.empty() ? 0 : jobs[0];
+        for (size_t index : jobs) {
+            if (longest(index) > longest(tail)) tail = index;
+        }
+        std::vector<std::string> chain;
+        std::unordered_set<size_t> onChain;
+        for (size_t index = tail; !jobs.empty() && onChain.insert(index).second;) {
+            chain.insert(chain.begin(), projects[index].name);
+            auto next = pathNext.find(index);
+            if (next == pathNext.end()) break;
+            index = next->second;
+        }
+
+        plan.criticalPath = chain;
+        plan.criticalMs = jobs.empty() ? 0 : pathMs[tail];
+        plan.jobs = requestedJobs > 0 ? requestedJobs : maxConcurrentBuilds;
+        plan.makespanMs = simulateMakespan(jobs, jobDeps, cost, plan.jobs);
+
+        // More slots stop helping once the critical path is the limit
+        for (size_t slotCount = 1; slotCount <= std::max<size_t>(plan.jobs, 1) * 4 && slotCount <= 256; slotCount *= 2) {
+            long makespan = simulateMakespan(jobs, jobDeps, cost, slotCount);
+            plan.scaling.push_back({slotCount, makespan});
+            if (makespan <= plan.criticalMs || slotCount >= jobs.size()) break;
+        }
+        return plan;
+    }
+
+    void printPlan() {
+        BuildPlan plan = computePlan();
+        auto seconds = [](long ms) {
+            std::ostringstream text;
+            text << std::fixed << std::setprecision(1) << ms / 1000.0 << "s";
+            return text.str();
+        };
+
+        std::cout << "\n" << colorize("=== Build Plan ===", Color::BOLD + Color::CYAN) << std::endl;
+        size_t estimated = 0;
+        for (const auto& entry : plan.entries) {
+            estimated += entry.estimated;
+            std::string estimate = (entry.estimated ? "~" : "") + seconds(entry.estimateMs);
+            std::cout << "  " << (entry.rebuild ? colorize("Rebuild   ", Color::YELLOW) : colorize("Up to date", Color::GREEN))
+                     << " " << std::left << std::setw(28) << entry.project << std::right
+                     << std::setw(9) << estimate << (entry.rebuild ? "  " + entry.reason : "") << std::endl;
+        }
+
+        std::cout << "\n  " << colorize("Would rebuild: ", Color::BOLD) << plan.rebuilds << " of " << plan.entries.size()
+                 << " jobs, " << seconds(plan.workMs) << " of work" << std::endl;
+        std::cout << "  " << colorize("Critical path: ", Color::BOLD);
+        for (size_t i = 0; i < plan.criticalPath.size(); ++i) std::cout << (i ? " -> " : "") << plan.criticalPath[i];
+        std::cout << " (" << seconds(plan.criticalMs) << ")" << std::endl;
+        std::cout << "  " << colorize("Makespan: ", Color::BOLD)
+                 << seconds(plan.makespanMs) << " at --jobs=" << plan.jobs << std::endl;
+        if (!plan.cycle.empty()) {
+            std::cout << "  " << colorize("[WARN]", Color::YELLOW) << " Dependency cycle: ";
+            for (size_t i = 0; i < plan.cycle.size(); ++i) std::cout << (i ? " -> " : "") << plan.cycle[i];
+            std::cout << " (built ignoring the order)" << std::endl;
+        }
+
+        std::cout << "\n  Jobs  Makespan" << std::endl;
+        for (const auto& step : plan.scaling) {
+            std::cout << "  " << std::setw(4) << step.first << "  " << std::setw(8) << seconds(step.second)
+                     << (step.second <= plan.criticalMs ? "  (critical path bound)" : "") << std::endl;
+        }
+        if (estimated > 0) {
+            std::cout << "\n  " << colorize("Note:", Color::BLUE) << " " << estimated
+                     << " jobs have no recorded rebuild time (~ uses the median)" << std::endl;
+        }
+        std::cout << std::endl;
+    }
+
+    // Memory, memory pressure (PSI) and load average from /proc
+    bool readSystemLoad(SystemLoad& load) {
+#ifdef __linux__
+        std::ifstream meminfo("/proc/meminfo");
+        std::string key;
+        long value;
+        std::string unit;
+        while (meminfo >> key >> value) {
+            std::getline(meminfo, unit);
+            if (key == "MemTotal:") load.memTotalKb = value;
+            else if (key == "MemAvailable:") load.memAvailableKb = value;
+        }
+
+        std::ifstream pressure("/proc/pressure/memory");
+        std::string line;
+        if (std::getline(pressure, line)) {
+            size_t pos = line.find("avg10=");
+            if (pos != std::string::npos) load.memPressure = std::atof(line.c_str() + pos + 6);
+        }
+
+        std::ifstream loadavg("/proc/loadavg");
+        loadavg >> load.loadAverage;
+        return load.memTotalKb > 0 && load.memAvailableKb > 0;
+#else
+        (void)load;
+        return false;
+#endif
+    }
+
+    // Lower the slot count under memory pressure or overload, raise it when the host is idle
+    void runConcurrencyController(std::atomic<bool>& stop) {
+        double cpus = std::max(1u, std::thread::hardware_concurrency());
+        auto lastChange = std::chrono::steady_clock::now() - std::chrono::seconds(10);
+
+        while (!stop) {
+            for (int i = 0; i < 5 && !stop; ++i) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            }
+
+            SystemLoad load;
+            if (stop || !readSystemLoad(load)) continue;
+            auto now = std::chrono::steady_clock::now();
+            if (now - lastChange < std::chrono::seconds(2)) continue;
+
+            double availablePercent = 100.0 * load.memAvailableKb / load.memTotalKb;
+            size_t slots = activeSlots.load();
+            size_t target = slots;
+            std::string reason;
+
+            if (load.memPressure > 25.0 || availablePercent < 5.0) {
+                target = std::max<size_t>(1, slots / 2);
+                reason = "severe memory pressure";
+            } else if (load.memPressure > 10.0 || availablePercent < 10.0) {
+                target = std::max<size_t>(1, slots - 1);
+                reason = "memory pressure";
+            } else if (load.loadAverage > 1.5 * cpus) {
+                target = std::max<size_t>(1, slots - 1);
+                reason = "load average";
+            } else if (load.memPressure < 1.0 && availablePercent > 20.0 && load.loadAverage < cpus) {
+                target = std::min(adaptiveCeiling, slots + 1);
+                reason = "idle capacity";
+            }
+
+            if (target != slots) {
+                activeSlots = target;
+                lastChange = now;
+                if (verboseMode) {
+                    std::lock_guard<std::mutex> lock(outputMutex);
+                    std::cout << colorize("  [ADAPT]", Color::CYAN) << " slots " << slots << " -> " << target
+                             << " (" << reason << ", " << std::fixed << std::setprecision(1) << availablePercent
+                             << "% free, psi " << load.memPressure << ", load " << load.loadAverage << ")"
+                             << std::endl;
+                    std::cout.unsetf(std::ios::fixed);
+                }
+            }
+        }
+    }
+
+    // Select CMake projects using the Ninja generator whose build dirs live under one root
+    void prepareNinjaGraph() {
+        ninjaGraphPrefixes.clear();
+        if (!ninjaGraphMode || cleanMode || timeReportMode) return;
+        if (!isCommandAvailable("ninja")) {
+            std::cerr << colorize("  [WARN]", Color::YELLOW)
+                     << " ninja not found, building projects separately" << std::endl;
+            return;
+        }
+
+        ninjaGraphRoot = normalizePath(customPath);
+        for (auto& proj : projects) {
+            // The graph builds after the scheduler, too late for the jobs that depend on a project
+            if (proj.buildSystem != BuildSystem::CMake || proj.isMakefileProject || proj.hasDependents) continue;
+            determineBuildSystem(proj);
+            if (proj.detectedGenerator != "Ninja") continue;
+
+            std::error_code ec;
+            fs::path rel = fs::relative(normalizePath(cmakeBuildDir(proj)), ninjaGraphRoot, ec);
+            std::string prefix = rel.generic_string();
+            if (ec || prefix.empty() || prefix.substr(0, 2) == "..") continue;
+            ninjaGraphPrefixes[proj.path] = prefix + "/";
+        }
+
+        if (verboseMode && !ninjaGraphPrefixes.empty()) {
+            std::cout << colorize("  [GRAPH]", Color::CYAN) << " " << ninjaGraphPrefixes.size()
+                     << " Ninja projects will share one build graph" << std::endl;
+        }
+    }
+
+    // Build every configured Ninja project through one top-level build.ninja (subninja per project)
+    void buildNinjaGraph() {
+        std::vector<ProjectInfo*> members;
+        for (auto& proj : projects) {
+            if (ninjaGraphPrefixes.count(proj.path) && proj.success) members.push_back(&proj);
+        }
+        if (members.empty()) return;
+
+        std::string graphFile = ninjaGraphRoot + "/.focal-run.ninja";
+        std::ofstream ninjaFile(graphFile);
+        ninjaFile << "# Generated by focal-run: combined build graph of all Ninja projects\n";
+        ninjaFile << "ninja_required_version = 1.5\n\n";
+        std::string allTargets;
+        for (auto* proj : members) {
+            const std::string& prefix = ninjaGraphPrefixes[proj->path];
+            ninjaFile << "subninja " << prefix << "build.ninja\n";
+            allTargets += " " + prefix + "all";
+        }
+        ninjaFile << "\nbuild focal-run-all: phony" << allTargets << "\n";
+        ninjaFile << "default focal-run-all\n";
+        ninjaFile.close();
+
+        // Only log lines appended by this run count towards per-project times
+        std::string logFile = ninjaGraphRoot + "/.ninja_log";
+        std::error_code ec;
+        std::uintmax_t logOffset = fs::exists(logFile) ? fs::file_size(logFile, ec) : 0;
+
+        std::string graphCmd = "ninja -C \"" + escapeShellArg(ninjaGraphRoot) + "\" -f .focal-run.ninja -k 0";
+        if (verboseMode) {
+            std::cout << colorize("  [GRAPH]", Color::GREEN) << " " << graphCmd << std::endl;
+        }
+
+        auto startTime = std::chrono::high_resolution_clock::now();
+        int graphResult = runCommand(verboseMode ? graphCmd : graphCmd + QUIET_REDIRECT);
+        auto endTime = std::chrono::high_resolution_clock::now();
+        auto graphTime = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
+
+        // .ninja_log v5: start \t end \t mtime \t output \t hash
+        std::unordered_map<std::string, std::pair<long long, long long>> spans;
+        std::ifstream log(logFile);
+        log.seekg(logOffset);
+        std::string line;
+        while (std::getline(log, line)) {
+            std::vector<std::string> fields;
+            std::stringstream ss(line);
+            std::string field;
+            while (std::getline(ss, field, '\t')) fields.push_back(field);
+            if (fields.size() < 4 || line[0] == '#') continue;
+            for (auto* proj : members) {
+                const std::string& prefix = ninjaGraphPrefixes[proj->path];
+                if (fields[3].compare(0, prefix.size(), prefix) != 0) continue;
+                long long start = std::atoll(fields[0].c_str());
+                long long end = std::atoll(fields[1].c_str());
+                auto it = spans.find(proj->path);
+                if (it == spans.end()) {
+                    spans[proj->path] = {start, end};
+                } else {
+                    it->second.first = std::min(it->second.first, start);
+                    it->second.second = std::max(it->second.second, end);
+                }
+                break;
+            }
+        }
+
+        for (auto* proj : members) {
+            auto span = spans.find(proj->path);
+            proj->stats.buildTime = std::chrono::milliseconds(
+                span != spans.end() ? span->second.second - span->second.first : 0);
+            proj->stats.totalTime = proj->stats.configTime + proj->stats.buildTime;
+
+            if (graphResult != 0) {
+                // Whatever is still out of date after `-k 0` belongs to a failed project
+                std::string checkCmd = "ninja -C \"" + escapeShellArg(ninjaGraphRoot)
+                                       + "\" -f .focal-run.ninja -n " + ninjaGraphPrefixes[proj->path] + "all";
+                proj->success = captureCommand(checkCmd + " 2>&1").find("no work to do") != std::string::npos;
+            }
+        }
+
+        if (verboseMode) {
+            std::cout << colorize("  [TIME]", Color::BLUE) << " Combined Ninja build: "
+                     << graphTime.count() << "ms for " << members.size() << " projects" << std::endl;
+        }
+        if (graphResult != 0) {
+            std::cerr << colorize("  [FAILED]", Color::RED) << " Combined Ninja build failed!" << std::endl;
+        }
+    }
+
+    static std::unordered_map<std::string, std::string> readCacheFile(const std::string& path) {
+        std::unordered_map<std::string, std::string> entries;
+        std::ifstream cacheFile(path);
+        std::string line;
+        while (std::getline(cacheFile, line)) {
+            size_t sep = line.find('=');
+            if (sep != std::string::npos) {
+                entries[line.substr(0, sep)] = line.substr(sep + 1);
+            }
+        }
+        return entries;
+    }
+
+    void loadConfigCache() {
+        if (!fs::exists(cacheFilePath)) return;
+        loadedCache = readCacheFile(cacheFilePath);
+        for (const auto& entry : loadedCache) configCache[entry.first] = entry.second;
+
+        if (verboseMode) {
+            std::cout << colorize("[CACHE]", Color::CYAN) 
+                     << " Loaded " << configCache.size() << " entries" << std::endl;
+        }
+    }
+
+    // Concurrent runs on one tree merge rather than overwrite each other: under a
+    // lock, the entries this run set or erased since loading are applied to the
+    // file as it is now, which is then replaced through a rename
+    void saveConfigCache() {
+        std::error_code ec;
+        fs::create_directories(lockDir(), ec);
+        FileLock lock;
+        lock.acquire(lockDir() + "/cache-" + hashString(normalizePath(cacheFilePath)) + ".lock", true);
+
+        std::unordered_map<std::string, std::string> merged = readCacheFile(cacheFilePath);
+        for (const auto& entry : loadedCache) {
+            if (!configCache.count(entry.first)) merged.erase(entry.first);
+        }
+        for (const auto& entry : configCache) {
+            auto loaded = loadedCache.find(entry.first);
+            if (loaded == loadedCache.end() || loaded->second != entry.second) merged[entry.first] = entry.second;
+        }
+
+        std::string temporary = cacheFilePath + ".tmp-" + std::to_string(processId());
+        std::ofstream cacheFile(temporary);
+        if (cacheFile.is_open()) {
+            for (const auto& pair : merged) {
+                cacheFile << pair.first << "=" << pair.second << std::endl;
+            }
+            cacheFile.close();
+            fs::rename(temporary, cacheFilePath, ec);
+            if (ec) {
+                fs::remove(temporary, ec);
+                return;
+            }
+            configCache = merged;
+            loadedCache = merged;
+            
+            if (verboseMode) {
+                std::cout << colorize("[CACHE]", Color::CYAN) 
+                         << " Saved " << configCache.size() << " entries" << std::endl;
+            }
+        }
+    }
+
+    void printProjects() {
+        scanProjects();
+
+        deduplicateProjects();
+
+        std::cout << "\n" << colorize("=== Available Projects ===", Color::BOLD + Color::CYAN) << std::endl;
+        
+        if (projects.empty()) {
+            std::cout << colorize("No projects found!", Color::YELLOW) << std::endl;
+            return;
+        }
+
+        for (auto& proj : projects) {
+            determineBuildSystem(proj);
+            
+            std::string typeIcon = "📦";
+            if (proj.buildSystem == BuildSystem::Rust) typeIcon = "🦀";
+            else if (proj.isMakefileProject) typeIcon = "🔧";
+            else if (proj.buildSystem == BuildSystem::CMake) typeIcon = "⚙️ ";
+            
+            std::cout << "  " << typeIcon << " " 
+                     << colorize(proj.name, Color::BOLD) << std::endl;
+            std::cout << "     Path: " << proj.path << std::endl;
+            std::cout << "     Generator: " << colorize(proj.detectedGenerator, Color::CYAN) << std::endl;
+            std::cout << std::endl;
+        }
+    }
+
+    void cleanAllBuildDirs() {
+        cleanedBuildDirs.clear();
+        try {
+            for (const auto& entry : fs::recursive_directory_iterator(customPath)) {
+                if (entry.is_directory()) {
+                    std::string dirname = entry.path().filename().string();
+                    if (dirname == "build" || dirname == "release" || dirname == "debug" || dirname == "target") {
+                        std::string cleanPath = entry.path().string();
+                        try {
+                            fs::remove_all(cleanPath);
+                            cleanedBuildDirs.push_back(cleanPath);
+                            std::cout << colorize("  [CLEAN]", Color::YELLOW) 
+                                     << " " << cleanPath << std::endl;
+                        } catch (const std::exception& e) {
+                            std::cerr << colorize("  [ERROR]", Color::RED) 
+                                     << " Cleaning " << cleanPath << ": " << e.what() << std::endl;
+                        }
+                    }
+                }
+            }
+        } catch (const std::exception& e) {
+            std::cerr << colorize("Error scanning for build directories: ", Color::RED) 
+                     << e.what() << std::endl;
+        }
+        if (!buildRoot.empty()) cleanBuildRoot();
+    }
+
+    // One "Resources:" line per measured project: CPU, memory, block I/O, context switches
+    void printUsage(const ProjectInfo& proj) {
+        const ResourceUsage& usage = proj.stats.usage;
+        if (usage.peakRssKb == 0) return;
+
+        std::ostringstream line;
+        line << std::fixed << std::setprecision(1)
+             << "cpu " << usage.cpuUserMs / 1000.0 << "s user + " << usage.cpuSysMs / 1000.0 << "s sys";
+        if (proj.stats.totalTime.count() > 0) {
+            line << " (" << (double)(usage.cpuUserMs + usage.cpuSysMs) / proj.stats.totalTime.count() << "x)";
+        }
+        line << ", peak " << usage.peakRssKb / 1024 << " MB"
+             << ", io " << usage.blockIn << " in / " << usage.blockOut << " out"
+             << ", ctx " << usage.ctxVoluntary << " vol / " << usage.ctxInvoluntary << " invol";
+
+        std::cout << "    Resources: " << line.str();
+        std::string profile = classifyUsage(usage, proj.stats.totalTime);
+        if (!profile.empty()) {
+            std::cout << " " << colorize("[" + profile + "]", profile == "memory-heavy" ? Color::YELLOW : Color::CYAN);
+        }
+        std::cout << std::endl;
+    }
+
+    void printReport() {
+        std::cout << "\n" << colorize("=== Build Report ===", Color::BOLD + Color::CYAN) << std::endl;
+        
+        if (cleanMode && allMode && !changedMode) {
+            for (const auto& path : cleanedBuildDirs) {
+                std::cout << colorize("  [CLEANED] ", Color::YELLOW) << path << std::endl;
+            }
+            std::cout << "\n" << colorize("  Summary: ", Color::BOLD) 
+                     << cleanedBuildDirs.size() << " directories cleaned" << std::endl;
+            return;
+        }
+
+        int successCount = 0;
+        int failCount = 0;
+        std::chrono::milliseconds totalTime{0};
+
+        for (const auto& proj : projects) {
+            if (cleanMode) {
+                std::cout << colorize("  [CLEANED] ", Color::YELLOW) << proj.name << std::endl;
+            } else {
+                if (proj.success) {
+                    std::cout << colorize("  ✓ [SUCCESS] ", Color::GREEN) << proj.name;
+                    if (verboseMode && proj.stats.totalTime.count() > 0) {
+                        std::cout << " (" << proj.stats.totalTime.count() << "ms)";
+                    }
+                    std::cout << std::endl;
+                    std::cout << "    Generator: " << proj.detectedGenerator << std::endl;
+                    if (!proj.workspaceRoot.empty()) {
+                        std::cout << "    Workspace: " << proj.workspaceRoot << std::endl;
+                    }
+                    if (proj.upToDate) {
+                        std::cout << "    Up to date: dependency outputs unchanged" << std::endl;
+                    }
+                    if (proj.reusedBuild) {
+                        std::cout << "    Reused: built by another focal-run" << std::endl;
+                    }
+                    printUsage(proj);
+                    printTestSummary(proj);
+                    successCount++;
+                    totalTime += proj.stats.totalTime;
+                } else {
+                    std::cout << colorize("  ✗ [FAILED] ", Color::RED) << proj.name << std::endl;
+                    std::cout << "    Generator: " << proj.detectedGenerator << std::endl;
+                    if (!proj.workspaceRoot.empty()) {
+                        std::cout << "    Workspace: " << proj.workspaceRoot << std::endl;
+                    }
+                    printUsage(proj);
+                    printTestSummary(proj);
+                    failCount++;
+                }
+            }
+        }
+
+        if (!cleanMode) {
+            std::cout << "\n" << colorize("  Summary: ", Color::BOLD);
+            std::cout << colorize(std::to_string(successCount) + " succeeded", Color::GREEN) << ", ";
+            std::cout << colorize(std::to_string(failCount) + " failed", failCount > 0 ? Color::RED : Color::GREEN);
+            
+            if (verboseMode && totalTime.count() > 0) {
+                std::cout << "\n" << colorize("  Total Time: ", Color::BOLD) 
+                         << totalTime.count() << "ms";
+                
+                if (totalTime.count() > 1000) {
+                    double seconds = totalTime.count() / 1000.0;
+                    std::cout << " (" << std::fixed << std::setprecision(2) << seconds << "s)";
+                }
+            }
+            std::cout << std::endl;
+        }
+        std::cout << std::endl;
+    }
+
+    void checkDependencies() {
+        std::cout << "\n" << colorize("=== Build Tools Check ===", Color::BOLD + Color::CYAN) << "\n" << std::endl;
+
+        std::vector<std::pair<std::string, std::string>> tools = {
+            {"cmake", "CMake"},
+            {"make", "Make"},
+            {"ninja", "Ninja"},
+            {"mingw32-make", "MinGW Make"},
+            {"g++", "GCC C++ Compiler"},
+            {"clang++", "Clang C++ Compiler"},
+            {"rustc", "Rust Compiler"},
+            {"cargo", "Cargo Package Manager"}
+        };
+
+        int availableCount = 0;
+
+        for (const auto& tool : tools) {
+            bool available = isCommandAvailable(tool.first);
+            std::string status = available ? colorize("✓ OK", Color::GREEN) : colorize("✗ Not Found", Color::RED);
+            std::cout << "  " << std::left << std::setw(25) << tool.second << ": " << status << std::endl;
+            if (available) availableCount++;
+        }
+
+        // Check Visual Studio
+#ifdef _WIN32
+        std::cout << "\n  " << colorize("Visual Studio:", Color::BOLD) << std::endl;
+        bool vsInstalled = checkVisualStudioInstalled();
+        std::string vsStatus = vsInstalled ? colorize("✓ Installed", Color::GREEN) : colorize("✗ Not Found", Color::RED);
+        std::cout << "    Installation: " << vsStatus << std::endl;
+#endif
+
+        std::cout << "\n  " << colorize("Summary: ", Color::BOLD) 
+                 << availableCount << "/" << tools.size() << " tools available" << std::endl;
+
+        if (availableCount == 0) {
+            std::cout << colorize("  ⚠ Warning: ", Color::YELLOW) 
+                     << "No build tools found. Please install CMake, Make, or MinGW." << std::endl;
+        } else if (availableCount < (int)tools.size()) {
+            std::cout << colorize("  ℹ Note: ", Color::BLUE) 
+                     << "Some tools are missing, but basic building should work." << std::endl;
+        } else {
+            std::cout << colorize("  ✓ All tools available!", Color::GREEN) << std::endl;
+        }
+
+        std::cout << std::endl;
+    }
+
+    bool buildSingleFile(const std::string& filename) {
+        std::string foundFile = "";
+        try {
+            for (const auto& entry : fs::recursive_directory_iterator(customPath)) {
+                if (entry.is_regular_file() && entry.path().filename().string() == filename) {
+                    foundFile = entry.path().string();
+                    break;
+                }
+            }
+        } catch (const std::exception& e) {
+            std::cerr << colorize("Error searching for file: ", Color::RED) << e.what() << std::endl;
+            return false;
+        }
+
+        if (foundFile.empty()) {
+            std::cerr << colorize("File '", Color::RED) << filename 
+                     << colorize("' not found!", Color::RED) << std::endl;
+            return false;
+        }
+
+        if (foundFile.substr(foundFile.size() - 4) != ".cpp") {
+            std::cerr << colorize("File '", Color::RED) << filename 
+                     << colorize("' is not a .cpp file!", Color::RED) << std::endl;
+            return false;
+        }
+
+        if (!buildSingleCppFile(foundFile)) {
+            return false;
+        }
+
+        if (benchMode) {
+            runBenchmarks({singleFileBenchTarget(foundFile)});
+        }
+        if (artifactStatsMode) {
+            runArtifactStats({singleFileArtifact(foundFile)});
+        }
+        return true;
+    }
+
+    std::string singleFileOutput(const std::string& cppFile) {
+        fs::path filePath(cppFile);
+        std::string dirPath = filePath.parent_path().string();
+        std::string filename = filePath.stem().string();
+
+#ifdef _WIN32
+        return dirPath + "/" + filename + ".exe";
+#else
+        return dirPath + "/" + filename;
+#endif
+    }
+
+    bool buildSingleCppFile(const std::string& cppFile) {
+        std::string outputFile = singleFileOutput(cppFile);
+
+        std::string escapedCpp = escapeShellArg(cppFile);
+        std::string escapedOut = escapeShellArg(outputFile);
+        std::string buildCmd = "g++ \"" + escapedCpp + "\" -o \"" + escapedOut + "\"";
+        
+        if (buildType == "Debug") {
+            buildCmd += " -g -O0 -Wall";
+        } else {
+            buildCmd += " -O2 -DNDEBUG";
+        }
+
+        std::string timeReportDir = (fs::temp_directory_path() / "focal-run-time-report").string();
+        if (timeReportMode) {
+            std::string launcher = writeTimeLauncher(timeReportDir);
+            buildCmd = "\"" + escapeShellArg(launcher) + "\" " + buildCmd +
+                       (compilerIsClang("g++") ? " -ftime-trace=\"" + escapeShellArg(timeReportDir) + "/\"" : " -ftime-report");
+        }
+        auto traceStart = fs::file_time_type::clock::now();
+
+        std::cout << colorize("[BUILD]", Color::GREEN) << " " << cppFile << std::endl;
+        
+        if (verboseMode) {
+            std::cout << colorize("  [CMD]", Color::MAGENTA) << " " << buildCmd << std::endl;
+        }
+
+        auto startTime = std::chrono::high_resolution_clock::now();
+        int buildResult = system(verboseMode ? buildCmd.c_str() : (buildCmd + QUIET_REDIRECT).c_str());
+        auto endTime = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
+
+        if (timeReportMode) {
+            collectTimeReport(timeReportDir, "", customPath, traceStart);
+        }
+
+        if (verboseMode) {
+            std::cout << colorize("  [TIME]", Color::BLUE) 
+                     << " Build: " << duration.count() << "ms" << std::endl;
+        }
+
+        if (buildResult == 0) {
+            std::cout << colorize("  ✓ [SUCCESS]", Color::GREEN) 
+                     << " Built: " << outputFile << std::endl;
+            return true;
+        } else {
+            std::cerr << colorize("  ✗ [FAILED]", Color::RED) 
+                     << " Build failed: " << cppFile << std::endl;
+            if (!verboseMode) {
+                std::cerr << "  Run with --verbose for details" << std::endl;
+            }
+            return false;
+        }
+    }
+
+    void scanAndBuildSingleCppFiles() {
+        std::vector<std::string> cppFiles;
+
+        try {
+            for (const auto& entry : fs::recursive_directory_iterator(customPath)) {
+                if (entry.is_regular_file() && entry.path().extension() == ".cpp") {
+                    std::string filePath = entry.path().string();
+                    std::string dirPath = entry.path().parent_path().string();
+
+                    bool hasCMake = fs::exists(dirPath + "/CMakeLists.txt");
+                    bool hasMakefile = fs::exists(dirPath + "/Makefile");
+                    bool hasCargo = fs::exists(dirPath + "/Cargo.toml");
+
+                    if (!hasCMake && !hasMakefile && !hasCargo) {
+                        cppFiles.push_back(filePath);
+                    }
+                }
+            }
+        } catch (const std::exception& e) {
+            std::cerr << colorize("Error scanning for .cpp files: ", Color::RED) 
+                     << e.what() << std::endl;
+            return;
+        }
+
+        if (cppFiles.empty()) {
+            std::cout << colorize("No standalone .cpp files found to build.", Color::YELLOW) << std::endl;
+            return;
+        }
+
+        std::cout << "\n" << colorize("=== Building Standalone C++ Files ===", Color::BOLD + Color::CYAN) << std::endl;
+        std::cout << "Found " << colorize(std::to_string(cppFiles.size()), Color::BOLD) 
+                 << " files to build\n" << std::endl;
+
+        int successCount = 0;
+        std::vector<BenchTarget> benchTargets;
+        std::vector<ArtifactStats> artifacts;
+        for (const auto& cppFile : cppFiles) {
+            if (buildSingleCppFile(cppFile)) {
+                successCount++;
+                std::string outputName = fs::path(singleFileOutput(cppFile)).filename().string();
+                if (benchMode && matchesPattern(outputName, benchPattern)) {
+                    benchTargets.push_back(singleFileBenchTarget(cppFile));
+                }
+                artifacts.push_back(singleFileArtifact(cppFile));
+            }
+            std::cout << std::endl;
+        }
+
+        std::cout << colorize("Summary: ", Color::BOLD) 
+                 << colorize(std::to_string(successCount) + " succeeded", Color::GREEN) << ", "
+                 << colorize(std::to_string(cppFiles.size() - successCount) + " failed", 
+                            (successCount == (int)cppFiles.size()) ? Color::GREEN : Color::RED) 
+                 << std::endl << std::endl;
+
+        if (benchMode) {
+            runBenchmarks(benchTargets);
+        }
+        if (artifactStatsMode) {
+            runArtifactStats(artifacts);
+        }
+    }
+
+    // Time focal-run's own phases on a generated tree whose build tools are no-op stubs
+    void runSelfBench() {
+        using Clock = std::chrono::high_resolution_clock;
+        auto elapsedMs = [](Clock::time_point start) {
+            return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        };
+
+        fs::path root = fs::temp_directory_path() /
+                        ("focal-run-self-bench-" + std::to_string(std::time(nullptr)));
+        fs::path stubDir = root / "stubs";
+        fs::path treeDir = root / "tree";
+        size_t dirCount = std::max(selfBenchDirs, selfBenchProjects);
+
+        std::cout << "\n" << colorize("=== Focal-RUN Self Benchmark ===", Color::BOLD + Color::CYAN) << std::endl;
+        std::cout << "Tree: " << dirCount << " directories, " << selfBenchProjects
+                  << " projects (" << root.string() << ")" << std::endl << std::endl;
+
+        // Stub build tools that succeed immediately
+        auto phaseStart = Clock::now();
+        fs::create_directories(stubDir);
+        for (const std::string tool : {"cmake", "make", "cargo", "ninja", "mingw32-make"}) {
+#ifdef _WIN32
+            std::ofstream stub(stubDir / (tool + ".bat"));
+            stub << "@exit /b 0\r\n";
+#else
+            fs::path stubPath = stubDir / tool;
+            std::ofstream stub(stubPath);
+            stub << "#!/bin/sh\nexit 0\n";
+            stub.close();
+            fs::permissions(stubPath, fs::perms::owner_all | fs::perms::group_read | fs::perms::group_exec |
+                            fs::perms::others_read | fs::perms::others_exec);
+#endif
+        }
+
+        // Balanced directory tree (fan-out 8) with one source file per directory;
+        // projects are spread evenly and cycle through CMake, Make and Cargo
+        std::vector<fs::path> dirs = {treeDir};
+        for (size_t i = 1; i < dirCount; ++i) {
+            dirs.push_back(dirs[(i - 1) / 8] / ("d" + std::to_string(i)));
+        }
+        size_t stride = std::max<size_t>(1, dirCount / selfBenchProjects);
+        size_t generated = 0;
+        for (size_t i = 0; i < dirs.size(); ++i) {
+            fs::create_directories(dirs[i]);
+            std::ofstream(dirs[i] / "source.cpp") << "int f" << i << "() { return " << i << "; }\n";
+            if (i % stride != stride - 1 || generated >= selfBenchProjects) continue;
+            switch (generated++ % 3) {
+                case 0:
+                    std::ofstream(dirs[i] / "CMakeLists.txt") << "cmake_minimum_required(VERSION 3.20)\n";
+                    break;
+                case 1:
+                    std::ofstream(dirs[i] / "Makefile") << "all:\n";
+                    break;
+                default:
+                    std::ofstream(dirs[i] / "Cargo.toml") << "[package]\nname = \"p" << i << "\"\n";
+                    break;
+            }
+        }
+        double generateMs = elapsedMs(phaseStart);
+
+        // Isolate state: stub PATH, private cache file, silent builds
+        std::string oldPath = getenv("PATH") ? getenv("PATH") : "";
+#ifdef _WIN32
+        _putenv_s("PATH", (stubDir.string() + ";" + oldPath).c_str());
+#else
+        setenv("PATH", (stubDir.string() + ":" + oldPath).c_str(), 1);
+#endif
+        std::string savedPath = customPath;
+        std::string savedCacheFile = cacheFilePath;
+        bool savedVerbose = verboseMode;
+        bool savedProgress = showProgress;
+        customPath = treeDir.string();
+        cacheFilePath = (root / ".focal-run-cache").string();
+        verboseMode = false;
+        showProgress = false;
+        projects.clear();
+        configCache.clear();
+        loadedCache.clear();
+
+        struct Phase {
+            std::string name;
+            double ms;
+            size_t items;
+            std::string unit;
+        };
+        std::vector<Phase> phases;
+        phases.push_back({"generate tree", generateMs, dirs.size(), "dir"});
+
+        phaseStart = Clock::now();
+        scanProjects();
+        phases.push_back({"scanProjects", elapsedMs(phaseStart), dirs.size(), "dir"});
+        size_t projectCount = projects.size();
+
+        phaseStart = Clock::now();
+        deduplicateProjects();
+        phases.push_back({"dedup sort", elapsedMs(phaseStart), projectCount, "project"});
+
+        std::vector<std::string> probes = {"cmake", "make", "ninja", "g++", "clang++", "rustc", "cargo"};
+        phaseStart = Clock::now();
+        for (const auto& tool : probes) {
+            isCommandAvailable(tool);
+        }
+        phases.push_back({"isCommandAvailable", elapsedMs(phaseStart), probes.size(), "probe"});
+
+        phaseStart = Clock::now();
+        for (auto& proj : projects) {
+            determineBuildSystem(proj);
+        }
+        phases.push_back({"determineBuildSystem", elapsedMs(phaseStart), projects.size(), "project"});
+
+        phaseStart = Clock::now();
+        saveConfigCache();
+        phases.push_back({"cache save", elapsedMs(phaseStart), configCache.size(), "entry"});
+
+        configCache.clear();
+        loadedCache.clear();
+        phaseStart = Clock::now();
+        loadConfigCache();
+        phases.push_back({"cache load", elapsedMs(phaseStart), configCache.size(), "entry"});
+
+        // Cost of one bare stub spawn, to separate tool cost from scheduling cost
+        const int spawnSamples = 20;
+        std::string stubCmd = "cmake" + std::string(QUIET_REDIRECT);
+        phaseStart = Clock::now();
+        for (int i = 0; i < spawnSamples; ++i) {
+            system(stubCmd.c_str());
+        }
+        double spawnMs = elapsedMs(phaseStart) / spawnSamples;
+        phases.push_back({"stub spawn", spawnMs * spawnSamples, (size_t)spawnSamples, "spawn"});
+
+        size_t spawns = 0;
+        for (const auto& proj : projects) {
+            spawns += (proj.buildSystem == BuildSystem::CMake) ? 2 : 1;
+        }
+
+        std::ostringstream sink;
+        std::streambuf* savedBuf = std::cout.rdbuf(sink.rdbuf());
+        phaseStart = Clock::now();
+        buildAllProjects();
+        double scheduleMs = elapsedMs(phaseStart);
+        std::cout.rdbuf(savedBuf);
+        size_t slots = std::max<size_t>(1, std::min(maxConcurrentBuilds, projects.size()));
+        double idealMs = spawns * spawnMs / slots;
+        phases.push_back({"build scheduling", scheduleMs, projects.size(), "project"});
+        phases.push_back({"  overhead vs ideal", std::max(0.0, scheduleMs - idealMs), projects.size(), "project"});
+
+        // Restore state
+#ifdef _WIN32
+        _putenv_s("PATH", oldPath.c_str());
+#else
+        setenv("PATH", oldPath.c_str(), 1);
+#endif
+        customPath = savedPath;
+        cacheFilePath = savedCacheFile;
+        verboseMode = savedVerbose;
+        showProgress = savedProgress;
+        projects.clear();
+        configCache.clear();
+        loadedCache.clear();
+        std::error_code ec;
+        fs::remove_all(root, ec);
+
+        std::cout << "  " << std::left << std::setw(24) << "Phase" << std::right << std::setw(12) << "Total"
+                  << "  " << "Per item" << std::endl;
+        for (const auto& phase : phases) {
+            std::ostringstream total, perItem;
+            total << std::fixed << std::setprecision(1) << phase.ms << "ms";
+            perItem << std::fixed << std::setprecision(1)
+                    << (phase.items ? phase.ms * 1000.0 / phase.items : 0.0) << "µs/" << phase.unit;
+            std::cout << "  " << std::left << std::setw(24) << phase.name << std::right << std::setw(12)
+                      << total.str() << "  " << perItem.str() << std::endl;
+        }
+        std::cout << "\n  Found " << projectCount << " projects, " << slots << " build slots, "
+                  << spawns << " stub spawns (ideal " << std::fixed << std::setprecision(1) << idealMs
+                  << "ms)" << std::endl << std::endl;
+        std::cout.unsetf(std::ios::fixed);
+    }
+
+    BenchTarget singleFileBenchTarget(const std::string& cppFile) {
+        std::error_code ec;
+        fs::path rel = fs::relative(cppFile, customPath, ec);
+        std::string output = singleFileOutput(cppFile);
+        return {ec ? cppFile : rel.generic_string(), fs::path(output).filename().string(),
+                "\"" + escapeShellArg(output) + "\""};
+    }
+
+    static bool isExecutableFile(const fs::path& path) {
+        std::string ext = path.extension().string();
+#ifdef _WIN32
+        return ext == ".exe";
+#else
+        std::error_code ec;
+        fs::perms perms = fs::status(path, ec).permissions();
+        if (ec || (perms & fs::perms::owner_exec) == fs::perms::none) return false;
+        std::string name = path.filename().string();
+        return name.find(".so") == std::string::npos && ext != ".dylib" && ext != ".a";
+#endif
+    }
+
+    // Collect cargo benches, labelled CTest tests and matching executables
+    std::vector<BenchTarget> discoverBenchTargets(const ProjectInfo& proj) {
+        std::vector<BenchTarget> targets;
+        std::string project = relativeProjectPath(proj);
+        std::string escapedPath = escapeShellArg(proj.path);
+
+        if (proj.buildSystem == BuildSystem::Rust) {
+            std::ifstream manifest(proj.path + "/Cargo.toml");
+            std::stringstream content;
+            content << manifest.rdbuf();
+            if (fs::exists(proj.path + "/benches") ||
+                content.str().find("[[bench]]") != std::string::npos) {
+                targets.push_back({project, "cargo bench", cargoInvocation(proj) + "bench"});
+            }
+            return targets;
+        }
+
+        std::string buildDir = cmakeBuildDir(proj);
+        if (!proj.isMakefileProject && fs::exists(buildDir + "/CTestTestfile.cmake")) {
+            std::string ctestCmd = "cd \"" + escapeShellArg(buildDir) + "\" && ctest -C " + proj.buildType
+                                   + " -L \"" + escapeShellArg(benchLabel) + "\"";
+            std::string listing = captureCommand(ctestCmd + " -N");
+            size_t pos = listing.find("Total Tests:");
+            if (pos != std::string::npos && std::atoi(listing.c_str() + pos + 12) > 0) {
+                targets.push_back({project, "ctest -L " + benchLabel, ctestCmd});
+            }
+        }
+
+        std::vector<fs::path> executables;
+        for (const auto& dir : {buildDir, proj.path + "/release", proj.path + "/debug"}) {
+            std::error_code ec;
+            if (!fs::is_directory(dir, ec)) continue;
+            for (auto it = fs::recursive_directory_iterator(dir, fs::directory_options::skip_permission_denied, ec);
+                 it != fs::recursive_directory_iterator(); it.increment(ec)) {
+                if (ec) break;
+                if (it->is_directory() && it->path().filename() == "CMakeFiles") {
+                    it.disable_recursion_pending();
+                } else if (it->is_regular_file()) {
+                    executables.push_back(it->path());
+                }
+            }
+        }
+        if (proj.isMakefileProject) {
+            std::error_code ec;
+            for (const auto& entry : fs::directory_iterator(proj.path, ec)) {
+                if (entry.is_regular_file()) executables.push_back(entry.path());
+            }
+        }
+
+        std::sort(executables.begin(), executables.end());
+        for (const auto& exe : executables) {
+            if (!matchesPattern(exe.filename().string(), benchPattern) || !isExecutableFile(exe)) continue;
+            std::error_code ec;
+            fs::path rel = fs::relative(exe, proj.path, ec);
+            fs::path absolute = fs::absolute(exe);
+            targets.push_back({project, ec ? exe.string() : rel.generic_string(),
+                               "cd \"" + escapeShellArg(absolute.parent_path().string()) + "\" && \""
+                               + escapeShellArg(absolute.string()) + "\""});
+        }
+        return targets;
+    }
+
+    // Run each target with warmup + repetitions on a pinned CPU and compare to history
+    void runBenchmarks(const std::vector<BenchTarget>& targets) {
+        std::cout << "\n" << colorize("=== Benchmarks ===", Color::BOLD + Color::CYAN) << std::endl;
+        if (targets.empty()) {
+            std::cout << colorize("No benchmark targets found.", Color::YELLOW) << std::endl << std::endl;
+            return;
+        }
+
+        std::string runId = historyRunId();
+
+        // History lines: runId \t project \t target \t comma-separated samples (ms)
+        std::vector<std::vector<std::string>> history;
+        std::ifstream historyIn(benchHistoryFile);
+        std::string line;
+        while (std::getline(historyIn, line)) {
+            std::vector<std::string> fields;
+            std::stringstream ss(line);
+            std::string field;
+            while (std::getline(ss, field, '\t')) fields.push_back(field);
+            if (fields.size() == 4) history.push_back(fields);
+        }
+        historyIn.close();
+
+#ifdef __linux__
+        // Affinity is inherited by the benchmark processes spawned from this thread
+        cpu_set_t originalMask;
+        bool pinned = false;
+        if (sched_getaffinity(0, sizeof(originalMask), &originalMask) == 0) {
+            int cpu = benchCpu;
+            for (int c = CPU_SETSIZE - 1; cpu < 0 && c >= 0; --c) {
+                if (CPU_ISSET(c, &originalMask)) cpu = c;
+            }
+            cpu_set_t pinnedMask;
+            CPU_ZERO(&pinnedMask);
+            CPU_SET(cpu, &pinnedMask);
+            pinned = sched_setaffinity(0, sizeof(pinnedMask), &pinnedMask) == 0;
+            if (verboseMode) {
+                std::cout << colorize("  [PIN]", Color::MAGENTA) << " CPU " << cpu
+                         << (pinned ? "" : " (failed, running unpinned)") << std::endl;
+            }
+        }
+#endif
+
+        std::vector<BenchResult> results;
+        for (const auto& target : targets) {
+            BenchResult result;
+            result.target = target;
+            std::cout << colorize("  [BENCH]", Color::GREEN) << " " << target.project
+                     << ": " << target.name << std::endl;
+            if (verboseMode) {
+                std::cout << colorize("  [CMD]", Color::MAGENTA) << " " << target.command << std::endl;
+            }
+
+            std::string quietCmd = target.command + QUIET_REDIRECT;
+            result.success = system(quietCmd.c_str()) == 0;
+            for (int rep = 0; result.success && rep < benchRepetitions; ++rep) {
+                auto startTime = std::chrono::high_resolution_clock::now();
+                result.success = system(quietCmd.c_str()) == 0;
+                auto endTime = std::chrono::high_resolution_clock::now();
+                result.samples.push_back(std::chrono::duration<double, std::milli>(endTime - startTime).count());
+            }
+
+            for (const auto& entry : history) {
+                if (entry[1] != target.project || entry[2] != target.name) continue;
+                if (!benchBaseline.empty() && entry[0] != benchBaseline) continue;
+                result.baseline.clear();
+                std::stringstream ss(entry[3]);
+                std::string sample;
+                while (std::getline(ss, sample, ',')) result.baseline.push_back(std::atof(sample.c_str()));
+            }
+
+            if (result.success && !result.baseline.empty()) {
+                double current = median(result.samples);
+                double base = median(result.baseline);
+                result.pValue = welchPValue(result.baseline, result.samples);
+                bool significant = result.pValue < 0.05;
+                result.regression = significant && current > base * (1.0 + benchThreshold / 100.0);
+                result.improvement = significant && current < base * (1.0 - benchThreshold / 100.0);
+            }
+            results.push_back(result);
+        }
+
+#ifdef __linux__
+        if (pinned) sched_setaffinity(0, sizeof(originalMask), &originalMask);
+#endif
+
+        std::ofstream historyOut(benchHistoryFile, std::ios::app);
+        for (const auto& result : results) {
+            if (!result.success) continue;
+            historyOut << runId << "\t" << result.target.project << "\t" << result.target.name << "\t";
+            for (size_t i = 0; i < result.samples.size(); ++i) {
+                historyOut << (i ? "," : "") << result.samples[i];
+            }
+            historyOut << std::endl;
+        }
+        historyOut.close();
+
+        printBenchReport(results, runId);
+    }
+
+    void printBenchReport(const std::vector<BenchResult>& results, const std::string& runId) {
+        std::cout << "\n" << colorize("=== Benchmark Report ===", Color::BOLD + Color::CYAN) << std::endl;
+        std::cout << "  Run: " << runId << "  Baseline: "
+                 << (benchBaseline.empty() ? "previous run" : benchBaseline) << std::endl << std::endl;
+
+        int regressions = 0, improvements = 0, failures = 0;
+        for (const auto& result : results) {
+            std::string title = result.target.project + ": " + result.target.name;
+            if (!result.success) {
+                std::cout << colorize("  ✗ [FAILED] ", Color::RED) << title << std::endl;
+                failures++;
+                continue;
+            }
+
+            std::ostringstream line;
+            line << std::fixed << std::setprecision(2) << median(result.samples) << "ms ±"
+                 << std::sqrt(variance(result.samples)) << " (n=" << result.samples.size() << ")";
+            if (!result.baseline.empty()) {
+                double base = median(result.baseline);
+                double delta = base > 0.0 ? (median(result.samples) - base) / base * 100.0 : 0.0;
+                line << ", baseline " << base << "ms, " << std::showpos << delta << std::noshowpos
+                     << "%, p=" << std::setprecision(3) << result.pValue;
+            } else {
+                line << ", no baseline";
+            }
+
+            if (result.regression) {
+                std::cout << colorize("  ✗ [REGRESSION] ", Color::RED) << title << std::endl;
+                regressions++;
+            } else if (result.improvement) {
+                std::cout << colorize("  ✓ [FASTER] ", Color::GREEN) << title << std::endl;
+                improvements++;
+            } else {
+                std::cout << colorize("  ✓ [OK] ", Color::GREEN) << title << std::endl;
+            }
+            std::cout << "    " << line.str() << std::endl;
+        }
+
+        std::cout << "\n" << colorize("  Summary: ", Color::BOLD)
+                 << colorize(std::to_string(regressions) + " regressed", regressions > 0 ? Color::RED : Color::GREEN)
+                 << ", " << improvements << " faster, "
+                 << colorize(std::to_string(failures) + " failed", failures > 0 ? Color::RED : Color::GREEN)
+                 << std::endl << std::endl;
+
+        if (regressions > 0 || failures > 0) {
+            benchRegressed = true;
+        }
+    }
+
+    // Name of this run in the benchmark and artifact histories
+    std::string historyRunId() {
+        if (!benchTag.empty()) return benchTag;
+        if (historyRun.empty()) {
+            std::time_t now = std::time(nullptr);
+            char stamp[32];
+            std::strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", std::localtime(&now));
+            historyRun = stamp;
+        }
+        return historyRun;
+    }
+
+    ArtifactStats singleFileArtifact(const std::string& cppFile) {
+        BenchTarget target = singleFileBenchTarget(cppFile);
+        ArtifactStats stats;
+        stats.project = target.project;
+        stats.name = target.name;
+        stats.path = singleFileOutput(cppFile);
+        std::vector<std::string> markers = startupMarkers(cppFile);
+        if (!markers.empty()) {
+            stats.timed = true;
+            std::stringstream ss(markers[0]);
+            std::string arg;
+            while (ss >> arg) stats.startupArgs.push_back(arg);
+        }
+        return stats;
+    }
+
+    // What follows each "Focal-Startup:" marker in a file
+    static std::vector<std::string> startupMarkers(const std::string& file) {
+        std::vector<std::string> markers;
+        std::ifstream in(file);
+        std::string line;
+        while (std::getline(in, line)) {
+            size_t marker = line.find("Focal-Startup:");
+            if (marker != std::string::npos) markers.push_back(line.substr(marker + 14));
+        }
+        return markers;
+    }
+
+    // Libraries and executables in a project's build outputs. Only executables
+    // named by a "# Focal-Startup: <artifact> [args]" marker in the project file
+    // are started, with those arguments (e.g. --version) so they exit once up
+    std::vector<ArtifactStats> discoverArtifacts(const ProjectInfo& proj) {
+        std::map<std::string, std::vector<std::string>> timed;
+        for (const char* manifestName : {"CMakeLists.txt", "Makefile", "Cargo.toml"}) {
+            for (const auto& marker : startupMarkers(proj.path + "/" + manifestName)) {
+                std::stringstream ss(marker);
+                std::string artifact, arg;
+                if (!(ss >> artifact)) continue;
+                while (ss >> arg) timed[artifact].push_back(arg);
+                timed.emplace(artifact, std::vector<std::string>());
+            }
+        }
+
+        std::vector<ArtifactStats> artifacts;
+        std::string project = relativeProjectPath(proj);
+        for (const auto& root : outputRoots(proj)) {
+            forEachOutputFile(root, true, [&](const fs::directory_entry& entry) {
+                ArtifactStats stats;
+                std::error_code ec;
+                fs::path rel = fs::relative(entry.path(), proj.path, ec);
+                stats.project = project;
+                stats.name = ec ? entry.path().string() : rel.generic_string();
+                stats.path = fs::absolute(entry.path()).lexically_normal().string();
+                auto marker = timed.find(stats.name);
+                if (marker == timed.end()) marker = timed.find(entry.path().filename().string());
+                if (marker != timed.end()) {
+                    stats.timed = true;
+                    stats.startupArgs = marker->second;
+                }
+                artifacts.push_back(stats);
+            });
+        }
+        std::sort(artifacts.begin(), artifacts.end(),
+                  [](const ArtifactStats& a, const ArtifactStats& b) { return a.name < b.name; });
+        return artifacts;
+    }
+
+    // Loaded section sizes by flags (executable, read-only, writable, NOBITS)
+    // and the DT_NEEDED count, for either ELF class and byte order.
+    // Returns e_type, or 0 when the file is not ELF (archives, Mach-O, PE)
+    static int readElfStats(const std::string& path, ArtifactStats& stats) {
+        std::ifstream in(path, std::ios::binary);
+        unsigned char ident[16] = {};
+        if (!in.read(reinterpret_cast<char*>(ident), sizeof(ident)) ||
+            ident[0] != 0x7f || ident[1] != 'E' || ident[2] != 'L' || ident[3] != 'F') {
+            return 0;
+        }
+
+        bool wide = ident[4] == 2;
+        bool little = ident[5] == 1;
+        int word = wide ? 8 : 4;
+        auto field = [&](uint64_t offset, int bytes) {
+            unsigned char raw[8] = {};
+            in.clear();
+            in.seekg(static_cast<std::streamoff>(offset));
+            in.read(reinterpret_cast<char*>(raw), bytes);
+            uint64_t value = 0;
+            for (int i = 0; i < bytes; ++i) value |= uint64_t(raw[little ? i : bytes - 1 - i]) << (8 * i);
+            return value;
+        };
+
+        const uint64_t SHF_WRITE = 0x1, SHF_ALLOC = 0x2, SHF_EXECINSTR = 0x4;
+        const uint64_t SHT_DYNAMIC = 6, SHT_NOBITS = 8, DT_NEEDED = 1;
+        uint64_t sectionTable = field(wide ? 0x28 : 0x20, word);
+        uint64_t entrySize = field(wide ? 0x3A : 0x2E, 2);
+        uint64_t sectionCount = field(wide ? 0x3C : 0x30, 2);
+        stats.needed = 0;
+        for (uint64_t i = 0; sectionTable > 0 && i < sectionCount; ++i) {
+            uint64_t header = sectionTable + i * entrySize;
+            uint64_t type = field(header + 4, 4);
+            uint64_t flags = field(header + 8, word);
+            uint64_t offset = field(header + (wide ? 0x18 : 0x10), word);
+            uint64_t size = field(header + (wide ? 0x20 : 0x14), word);
+            if (flags & SHF_ALLOC) {
+                if (type == SHT_NOBITS) stats.bss += size;
+                else if (flags & SHF_EXECINSTR) stats.text += size;
+                else if (flags & SHF_WRITE) stats.data += size;
+                else stats.rodata += size;
+            }
+            if (type == SHT_DYNAMIC) {
+                for (uint64_t entry = 0; entry + 2 * word <= size; entry += 2 * word) {
+                    uint64_t tag = field(offset + entry, word);
+                    if (tag == 0) break;
+                    if (tag == DT_NEEDED) stats.needed++;
+                }
+            }
+        }
+        return static_cast<int>(field(16, 2));
+    }
+
+    // Spawn-to-exit time in ms of a program run with its Focal-Startup
+    // arguments and stdin at /dev/null; -1 if it did not start, failed or
+    // outlived the timeout, after which its process group is killed. The exit
+    // is polled every 0.1ms. A cold run first drops the binary from the page cache
+    double measureStartup(const std::string& path, const std::vector<std::string>& startupArgs, bool cold) {
+        const long timeoutMs = 5000;
+#ifdef _WIN32
+        (void)cold;
+        (void)timeoutMs;
+        std::string cmd = "\"" + path + "\"";
+        for (const auto& arg : startupArgs) cmd += " \"" + escapeShellArg(arg) + "\"";
+        cmd += std::string(" < NUL") + QUIET_REDIRECT;
+        auto startTime = std::chrono::steady_clock::now();
+        system(cmd.c_str());
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+#else
+#ifdef __linux__
+        if (cold) {
+            int fd = open(path.c_str(), O_RDONLY);
+            if (fd >= 0) {
+                fdatasync(fd);
+                posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+                close(fd);
+            }
+        }
+#else
+        (void)cold;
+#endif
+        std::vector<std::string> args = {fs::absolute(path).string()};
+        args.insert(args.end(), startupArgs.begin(), startupArgs.end());
+        std::vector<char*> argv;
+        for (auto& arg : args) argv.push_back(&arg[0]);
+        argv.push_back(nullptr);
+        std::string dir = fs::path(args[0]).parent_path().string();
+
+        auto startTime = std::chrono::steady_clock::now();
+        pid_t pid = fork();
+        if (pid < 0) return -1.0;
+        if (pid == 0) {
+            setpgid(0, 0);
+            int devNull = open("/dev/null", O_RDWR);
+            if (devNull >= 0) {
+                dup2(devNull, STDIN_FILENO);
+                dup2(devNull, STDOUT_FILENO);
+                dup2(devNull, STDERR_FILENO);
+            }
+            if (chdir(dir.c_str()) != 0) _exit(127);
+            execv(argv[0], argv.data());
+            _exit(127);
+        }
+        setpgid(pid, pid);
+
+        int status = 0;
+        while (true) {
+            pid_t done = waitpid(pid, &status, WNOHANG);
+            if (done == pid) break;
+            if (done < 0 && errno != EINTR) return -1.0;
+            auto waited = std::chrono::steady_clock::now() - startTime;
+            if (std::chrono::duration_cast<std::chrono::milliseconds>(waited).count() > timeoutMs) {
+                kill(-pid, SIGKILL);
+                while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {}
+                return -1.0;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+        double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) return -1.0;
+        return elapsed;
+#endif
+    }
+
+    static std::string formatBytes(uintmax_t bytes) {
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(1);
+        if (bytes < 1024) out << bytes << " B";
+        else if (bytes < 1024 * 1024) out << bytes / 1024.0 << " KB";
+        else out << bytes / (1024.0 * 1024.0) << " MB";
+        return out.str();
+    }
+
+    // Measure sizes, dynamic dependencies and startup time of each artifact and
+    // compare with the last build that recorded it
+    void runArtifactStats(std::vector<ArtifactStats> artifacts) {
+        std::cout << "\n" << colorize("=== Artifacts ===", Color::BOLD + Color::CYAN) << std::endl;
+        if (artifacts.empty()) {
+            std::cout << colorize("No build artifacts found.", Color::YELLOW) << std::endl << std::endl;
+            return;
+        }
+
+        std::string runId = historyRunId();
+
+        // History lines: runId \t project \t artifact \t size \t text \t rodata \t data \t bss
+        // \t needed \t coldMs \t warmMs, with -1 for what was not measured
+        std::map<std::pair<std::string, std::string>, std::vector<std::string>> previous;
+        std::ifstream historyIn(artifactHistoryFile);
+        std::string line;
+        while (std::getline(historyIn, line)) {
+            std::vector<std::string> fields;
+            std::stringstream ss(line);
+            std::string field;
+            while (std::getline(ss, field, '\t')) fields.push_back(field);
+            if (fields.size() == 11) previous[{fields[1], fields[2]}] = fields;
+        }
+        historyIn.close();
+
+        std::vector<ArtifactStats> results;
+        std::set<std::string> seen;
+        for (auto& stats : artifacts) {
+            // Workspace members share a cargo target dir
+            if (!seen.insert(stats.path).second) continue;
+            std::error_code ec;
+            stats.size = fs::file_size(stats.path, ec);
+            if (ec) continue;
+
+            std::cout << colorize("  [ARTIFACT]", Color::GREEN) << " " << stats.project
+                     << ": " << stats.name << std::endl;
+            readElfStats(stats.path, stats);
+            if (stats.timed && isExecutableFile(stats.path)) {
+                stats.coldMs = measureStartup(stats.path, stats.startupArgs, true);
+                std::vector<double> warm;
+                for (int run = 0; stats.coldMs >= 0.0 && run < artifactRuns; ++run) {
+                    double ms = measureStartup(stats.path, stats.startupArgs, false);
+                    if (ms < 0.0) break;
+                    warm.push_back(ms);
+                }
+                if (!warm.empty()) stats.warmMs = median(warm);
+            }
+
+            auto entry = previous.find({stats.project, stats.name});
+            if (entry != previous.end()) {
+                stats.baseline = entry->second;
+                compareArtifact(stats);
+            }
+            results.push_back(stats);
+        }
+
+        std::ofstream historyOut(artifactHistoryFile, std::ios::app);
+        for (const auto& stats : results) {
+            historyOut << runId << "\t" << stats.project << "\t" << stats.name << "\t" << stats.size
+                      << "\t" << stats.text << "\t" << stats.rodata << "\t" << stats.data << "\t" << stats.bss
+                      << "\t" << stats.needed << "\t" << stats.coldMs << "\t" << stats.warmMs << std::endl;
+        }
+        historyOut.close();
+
+        printArtifactReport(results, runId);
+    }
+
+    // Growth past the threshold is a regression; sizes must also grow by 1 KB
+    // and warm startup by 1ms, so padding and timer noise are not reported.
+    // Cold startup depends on the disk and is recorded only
+    void compareArtifact(ArtifactStats& stats) {
+        auto grew = [&](double before, double after, double floor) {
+            return before >= 0.0 && after >= 0.0 && after - before >= floor &&
+                   after > before * (1.0 + artifactThreshold / 100.0);
+        };
+        auto percent = [](double before, double after) {
+            std::ostringstream out;
+            out << std::fixed << std::setprecision(1) << std::showpos
+                << (before > 0.0 ? (after - before) / before * 100.0 : 100.0) << "%";
+            return out.str();
+        };
+
+        const char* sections[] = {"size", "text", "rodata", "data", "bss"};
+        uintmax_t current[] = {stats.size, stats.text, stats.rodata, stats.data, stats.bss};
+        for (int i = 0; i < 5; ++i) {
+            double before = std::atof(stats.baseline[3 + i].c_str());
+            if (grew(before, static_cast<double>(current[i]), 1024.0)) {
+                stats.regressions.push_back(std::string(sections[i]) + " " + percent(before, current[i]) + " (" +
+                                            formatBytes(static_cast<uintmax_t>(before)) + " → " +
+                                            formatBytes(current[i]) + ")");
+            }
+        }
+
+        int neededBefore = std::atoi(stats.baseline[8].c_str());
+        if (neededBefore >= 0 && stats.needed > neededBefore) {
+            stats.regressions.push_back("needed libraries " + std::to_string(neededBefore) + " → " +
+                                        std::to_string(stats.needed));
+        }
+
+        double warmBefore = std::atof(stats.baseline[10].c_str());
+        if (grew(warmBefore, stats.warmMs, 1.0)) {
+            std::ostringstream out;
+            out << std::fixed << std::setprecision(2) << "warm startup " << percent(warmBefore, stats.warmMs)
+                << " (" << warmBefore << "ms → " << stats.warmMs << "ms)";
+            stats.regressions.push_back(out.str());
+        }
+    }
+
+    void printArtifactReport(const std::vector<ArtifactStats>& results, const std::string& runId) {
+        std::cout << "\n" << colorize("=== Artifact Report ===", Color::BOLD + Color::CYAN) << std::endl;
+        std::cout << "  Run: " << runId << "  Baseline: previous build" << std::endl << std::endl;
+
+        int regressions = 0;
+        for (const auto& stats : results) {
+            std::string title = stats.project + ": " + stats.name;
+            if (!stats.regressions.empty()) {
+                std::cout << colorize("  ✗ [REGRESSION] ", Color::RED) << title << std::endl;
+                regressions++;
+            } else {
+                std::cout << colorize("  ✓ [OK] ", Color::GREEN) << title << std::endl;
+            }
+
+            std::ostringstream line;
+            line << formatBytes(stats.size);
+            if (stats.needed >= 0) {
+                line << " (text " << formatBytes(stats.text) << ", rodata " << formatBytes(stats.rodata)
+                     << ", data " << formatBytes(stats.data) << ", bss " << formatBytes(stats.bss)
+                     << "), " << stats.needed << " needed";
+            }
+            line << std::fixed << std::setprecision(2);
+            if (stats.warmMs >= 0.0) {
+                line << ", startup " << stats.warmMs << "ms warm, " << stats.coldMs << "ms cold";
+            } else if (stats.coldMs >= 0.0) {
+                line << ", startup " << stats.coldMs << "ms cold";
+            } else if (stats.timed) {
+                line << ", startup not measured (failed, or still running after 5s)";
+            }
+            if (stats.baseline.empty()) {
+                line << ", no baseline";
+            } else {
+                line << ", baseline " << formatBytes(std::strtoull(stats.baseline[3].c_str(), nullptr, 10))
+                     << " from " << stats.baseline[0];
+            }
+            std::cout << "    " << line.str() << std::endl;
+            for (const auto& regression : stats.regressions) {
+                std::cout << colorize("    " + regression, Color::RED) << std::endl;
+            }
+        }
+
+        std::cout << "\n" << colorize("  Summary: ", Color::BOLD)
+                 << colorize(std::to_string(regressions) + " regressed", regressions > 0 ? Color::RED : Color::GREEN)
+                 << ", " << results.size() << " tracked" << std::endl << std::endl;
+
+        if (regressions > 0) {
+            benchRegressed = true;
+        }
+    }
+};
+
+#endif // FOCAL_RUN_HPP